@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cmath>    // for std::exp, std::log, std::sqrt
+#include <cstddef>  // for std::size_t
+#include <vector>   // for std::vector
+
+/**
+ * Tape-based reverse-mode automatic differentiation (AAD)
+ *
+ * Every operation on an AadNumber appends a node to the tape of the calling
+ * thread: the indices of its arguments and the local partial derivatives
+ * with respect to them. Sweeping the tape backwards from an output then
+ * yields the derivative of that output with respect to every recorded
+ * input at once, for a cost that is a small multiple of the recording and
+ * independent of the number of inputs.
+ *
+ * Tapes are pooled per thread: rewinding to a mark drops the nodes recorded
+ * after it but keeps the memory, so recording path after path does not
+ * allocate once the tape has grown to the size of one path.
+ */
+
+class Tape {
+    public:
+        /**
+         * One recorded operation with at most two active arguments (-1 = unused)
+         */
+        struct Node {
+            int arg[2];
+            double partial[2];
+        };
+
+        /**
+         * Records an operation and returns its node index
+         * Constant arguments (index -1) are dropped; an operation on constants only is
+         * not recorded and returns -1
+         */
+        int record(int a, double da, int b = -1, double db = 0.0) {
+            if (a < 0) {
+                a = b;
+                da = db;
+                b = -1;
+            }
+            if (a < 0) return -1;
+            nodes.push_back({{a, b}, {da, db}});
+            return static_cast<int>(nodes.size()) - 1;
+        }
+
+        /**
+         * Records an independent input and returns its node index
+         */
+        int input() {
+            nodes.push_back({{-1, -1}, {0.0, 0.0}});
+            return static_cast<int>(nodes.size()) - 1;
+        }
+
+        std::size_t size() const { return nodes.size(); }
+
+        /**
+         * Drops every node recorded after the mark, keeping the memory
+         *
+         * @param mark Tape size to return to
+         */
+        void rewind(std::size_t mark) { nodes.resize(mark); }
+
+        /**
+         * Propagates adjoints backwards through nodes [begin, end)
+         * Adjoints of nodes before begin are accumulated, not propagated further
+         *
+         * @param adjoints One adjoint per node, seeded by the caller
+         * @param end One past the last node to sweep
+         * @param begin First node to sweep
+         */
+        void propagate(double* adjoints, std::size_t end, std::size_t begin) const {
+            for (std::size_t i = end; i-- > begin;) {
+                double w = adjoints[i];
+                if (w == 0.0) continue;
+                const Node& node = nodes[i];
+                if (node.arg[0] >= 0) adjoints[node.arg[0]] += node.partial[0] * w;
+                if (node.arg[1] >= 0) adjoints[node.arg[1]] += node.partial[1] * w;
+            }
+        }
+
+        /**
+         * Tape of the calling thread
+         */
+        static Tape& local() {
+            thread_local Tape tape;
+            return tape;
+        }
+
+    private:
+        std::vector<Node> nodes;
+};
+
+/**
+ * A double that records its operations on the calling thread's tape
+ * Numbers built from a plain double are constants and record nothing
+ */
+class AadNumber {
+    public:
+        AadNumber() = default;
+        AadNumber(double x) : val(x) { }
+
+        /**
+         * Creates an independent input on the calling thread's tape
+         */
+        static AadNumber input(double x) { return {x, Tape::local().input()}; }
+
+        double value() const { return val; }
+        int index() const { return idx; }
+
+        friend AadNumber operator+(const AadNumber& a, const AadNumber& b) {
+            return {a.val + b.val, Tape::local().record(a.idx, 1.0, b.idx, 1.0)};
+        }
+        friend AadNumber operator-(const AadNumber& a, const AadNumber& b) {
+            return {a.val - b.val, Tape::local().record(a.idx, 1.0, b.idx, -1.0)};
+        }
+        friend AadNumber operator*(const AadNumber& a, const AadNumber& b) {
+            return {a.val * b.val, Tape::local().record(a.idx, b.val, b.idx, a.val)};
+        }
+        friend AadNumber operator/(const AadNumber& a, const AadNumber& b) {
+            double inv = 1.0 / b.val;
+            return {a.val * inv, Tape::local().record(a.idx, inv, b.idx, -a.val * inv * inv)};
+        }
+        friend AadNumber exp(const AadNumber& a) {
+            double e = std::exp(a.val);
+            return {e, Tape::local().record(a.idx, e)};
+        }
+        friend AadNumber log(const AadNumber& a) {
+            return {std::log(a.val), Tape::local().record(a.idx, 1.0 / a.val)};
+        }
+        friend AadNumber sqrt(const AadNumber& a) {
+            double root = std::sqrt(a.val);
+            return {root, Tape::local().record(a.idx, 0.5 / root)};
+        }
+
+        /**
+         * max(a, 0), with derivative 1 above zero and 0 below (the pathwise convention)
+         */
+        friend AadNumber positive_part(const AadNumber& a) {
+            bool positive = a.val > 0.0;
+            return {positive ? a.val : 0.0, Tape::local().record(a.idx, positive ? 1.0 : 0.0)};
+        }
+
+    private:
+        double val = 0.0;
+        int idx = -1;  // node on the tape, -1 for a constant
+
+        AadNumber(double x, int index) : val(x), idx(index) { }
+};
@@ -0,0 +1,148 @@
+#include "aad_greeks.h"
+
+#include <algorithm>  // for std::any_of, std::fill
+#include <numeric>    // for std::accumulate
+
+/**
+ * Implementation of the adjoint path kernel
+ */
+
+namespace {
+
+/**
+ * Undiscounted payoff recorded on the tape
+ */
+AadNumber recorded_payoff(PayoffType type, const AadNumber& K, const AadNumber& terminal, const AadNumber& average) {
+    switch (type) {
+        case PayoffType::Call: return positive_part(terminal - K);
+        case PayoffType::Put: return positive_part(K - terminal);
+        case PayoffType::DigitalCall: return terminal.value() > K.value() ? 1.0 : 0.0;
+        case PayoffType::DigitalPut: return terminal.value() < K.value() ? 1.0 : 0.0;
+        case PayoffType::Forward: return terminal - K;
+        case PayoffType::AsianCall: return positive_part(average - K);
+        case PayoffType::AsianPut: return positive_part(K - average);
+    }
+    return 0.0;
+}
+
+}  // namespace
+
+double AadSensitivities::vega() const {
+    return std::accumulate(step_vegas.begin(), step_vegas.end(), 0.0);
+}
+
+void AadReduction::reset(const std::vector<Payoff>& payoffs, const AadModel& aad_model) {
+    model = aad_model;
+    track_average = std::any_of(payoffs.begin(), payoffs.end(),
+                                [](const Payoff& payoff) { return is_path_dependent(payoff.type); });
+    paths = 0;
+    sums.assign(payoffs.size(), AadSensitivities{});
+    for (AadSensitivities& sum : sums) {
+        sum.step_vegas.assign(model.step_volatilities.size(), 0.0);
+    }
+    outputs.resize(payoffs.size());
+}
+
+void AadReduction::begin() {
+    Tape& tape = Tape::local();
+    start = tape.size();
+    int steps = static_cast<int>(model.step_volatilities.size());
+
+    spot = AadNumber::input(model.spot);
+    strike = AadNumber::input(model.strike);
+    rate = AadNumber::input(model.rate);
+    expiry = AadNumber::input(model.expiry);
+    volatilities.resize(steps);
+    for (int j = 0; j < steps; j++) {
+        volatilities[j] = AadNumber::input(model.step_volatilities[j]);
+    }
+
+    log_spot = log(spot);
+    discount = exp(AadNumber(0.0) - rate * expiry);
+    AadNumber dt = expiry / AadNumber(steps);
+    AadNumber sqrt_dt = sqrt(dt);
+    drifts.resize(steps);
+    diffusions.resize(steps);
+    for (int j = 0; j < steps; j++) {
+        drifts[j] = (rate - AadNumber(0.5) * volatilities[j] * volatilities[j]) * dt;
+        diffusions[j] = volatilities[j] * sqrt_dt;
+    }
+    mark = tape.size();
+
+    // One path records at most 3 nodes per step, 2 more per step for the average,
+    // 2 at expiration and 3 per payoff
+    stride = mark + 5 * static_cast<std::size_t>(steps) + 3 * outputs.size() + 2;
+    adjoints.assign(outputs.size() * stride, 0.0);
+}
+
+void AadReduction::add(const std::vector<Payoff>& payoffs, const double* Z, int lanes) {
+    Tape& tape = Tape::local();
+    int steps = static_cast<int>(drifts.size());
+
+    for (int lane = 0; lane < lanes; lane++) {
+        AadNumber log_price = log_spot;
+        AadNumber price_sum = 0.0;
+        for (int j = 0; j < steps; j++) {
+            log_price = log_price + (drifts[j] + diffusions[j] * Z[static_cast<std::size_t>(j) * lanes + lane]);
+            if (track_average) price_sum = price_sum + exp(log_price);
+        }
+        AadNumber terminal = exp(log_price);
+        AadNumber average = track_average ? price_sum / AadNumber(steps) : AadNumber(0.0);
+        for (std::size_t p = 0; p < payoffs.size(); p++) {
+            AadNumber K = payoffs[p].type == PayoffType::Forward ? AadNumber(payoffs[p].strike) : strike;
+            outputs[p] = (discount * recorded_payoff(payoffs[p].type, K, terminal, average)).index();
+        }
+
+        // One backward sweep per payoff, down to the shared part where the adjoints accumulate
+        for (std::size_t p = 0; p < payoffs.size(); p++) {
+            double* adjoint = &adjoints[p * stride];
+            std::fill(adjoint + mark, adjoint + tape.size(), 0.0);
+            adjoint[outputs[p]] = 1.0;
+            tape.propagate(adjoint, tape.size(), mark);
+        }
+        tape.rewind(mark);
+    }
+    paths += lanes;
+}
+
+void AadReduction::end() {
+    Tape& tape = Tape::local();
+    for (std::size_t p = 0; p < sums.size(); p++) {
+        double* adjoint = &adjoints[p * stride];
+        tape.propagate(adjoint, mark, start);
+        sums[p].delta += adjoint[spot.index()];
+        sums[p].strike += adjoint[strike.index()];
+        sums[p].rho += adjoint[rate.index()];
+        sums[p].theta += adjoint[expiry.index()];
+        for (std::size_t j = 0; j < volatilities.size(); j++) {
+            sums[p].step_vegas[j] += adjoint[volatilities[j].index()];
+        }
+    }
+    tape.rewind(start);
+}
+
+void AadReduction::merge(const AadReduction& other) {
+    paths += other.paths;
+    for (std::size_t p = 0; p < sums.size(); p++) {
+        sums[p].delta += other.sums[p].delta;
+        sums[p].strike += other.sums[p].strike;
+        sums[p].rho += other.sums[p].rho;
+        sums[p].theta += other.sums[p].theta;
+        for (std::size_t j = 0; j < sums[p].step_vegas.size(); j++) {
+            sums[p].step_vegas[j] += other.sums[p].step_vegas[j];
+        }
+    }
+}
+
+AadSensitivities AadReduction::sensitivities(int i) const {
+    AadSensitivities result = sums[i];
+    double scale = paths > 0 ? 1.0 / paths : 0.0;
+    result.delta *= scale;
+    result.strike *= scale;
+    result.rho *= scale;
+    result.theta *= -scale;  // sums hold d/dT; theta runs the other way
+    for (double& vega : result.step_vegas) {
+        vega *= scale;
+    }
+    return result;
+}
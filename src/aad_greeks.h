@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <vector>   // for std::vector
+
+#include "aad.h"
+#include "payoff.h"
+
+/**
+ * Adjoint (AAD) sensitivities of Monte Carlo prices to every model input
+ *
+ * Each path is recorded on the thread's tape in the same log-space form as
+ * advance_log_prices, ln S_{j+1} = ln S_j + drift_j + diffusion_j Z_j, and
+ * swept backwards once per payoff. The inputs are the spot, the strike, the
+ * rate, the expiry and one volatility per time step, so a term structure of
+ * volatilities gets a vega for every step at no extra cost.
+ *
+ * The step coefficients do not depend on the path. They are recorded once per
+ * chunk of paths, ahead of a tape mark. Each path only records its own
+ * nodes after the mark and is swept back to it, so its adjoints pile up on
+ * the shared coefficients. One final sweep over the shared part turns the
+ * accumulated adjoints into input sensitivities. Per path this costs a few
+ * nodes per step, whatever the number of inputs.
+ *
+ * The derivatives are pathwise (the derivative of max(x, 0) is taken as
+ * 1{x > 0}), so they match the pathwise estimators of greeks.h. Payoffs
+ * that are discontinuous in the price, such as digitals, have zero pathwise
+ * derivatives and need the likelihood-ratio or bump-and-revalue greeks.
+ * Second-order greeks (gamma) are not available from a first-order sweep.
+ */
+
+/**
+ * Inputs the sensitivities are taken with respect to
+ */
+struct AadModel {
+    double spot = 0.0;
+    double strike = 0.0;
+    double rate = 0.0;
+    double expiry = 0.0;
+    std::vector<double> step_volatilities;  // one per simulated step
+};
+
+/**
+ * Discounted sensitivities of one payoff's price
+ */
+struct AadSensitivities {
+    double delta = 0.0;              // d price / d S_0
+    double strike = 0.0;             // d price / d K
+    double rho = 0.0;                // d price / d r
+    double theta = 0.0;              // d price / d t = -d price / d T
+    std::vector<double> step_vegas;  // d price / d sigma_j for every step j
+
+    /**
+     * Vega of a parallel shift of every step volatility
+     */
+    double vega() const;
+};
+
+/**
+ * Accumulates adjoint sensitivities of every payoff in a set over a chunk of paths
+ * A chunk is recorded between begin() and end() on one thread
+ */
+class AadReduction {
+    public:
+        AadReduction() = default;
+
+        /**
+         * Clears all sums for a new run, keeping the allocated buffers
+         *
+         * @param payoffs Payoff set to differentiate
+         * @param model Inputs of the simulation
+         */
+        void reset(const std::vector<Payoff>& payoffs, const AadModel& model);
+
+        /**
+         * Records the inputs and the per-step coefficients shared by every path on the calling thread's tape
+         */
+        void begin();
+
+        /**
+         * Records, sweeps and discards a block of paths
+         *
+         * @param payoffs The payoff set this reduction was reset for
+         * @param Z Normals laid out [step][lane], one step per model volatility
+         * @param lanes Number of paths in the block
+         */
+        void add(const std::vector<Payoff>& payoffs, const double* Z, int lanes);
+
+        /**
+         * Sweeps the shared part of the tape, adds the input adjoints to the
+         * sums and rewinds the tape to where begin() found it
+         */
+        void end();
+
+        /**
+         * Merges another partial reduction into this one
+         *
+         * @param other Reduction over a disjoint set of paths
+         */
+        void merge(const AadReduction& other);
+
+        long count() const { return paths; }
+
+        /**
+         * Discounted sensitivities of payoff i averaged over all paths added so far
+         *
+         * @param i Index of the payoff in the set
+         */
+        AadSensitivities sensitivities(int i) const;
+
+    private:
+        AadModel model;
+        bool track_average = false;
+        long paths = 0;
+        std::vector<AadSensitivities> sums;  // per payoff, summed over paths (theta as d/dT)
+
+        // Shared part of the tape, valid between begin() and end()
+        std::size_t start = 0;  // tape size before begin()
+        std::size_t mark = 0;   // tape size after the shared part
+        std::size_t stride = 0;  // adjoints reserved per payoff (bound on the size of the tape with one path)
+        AadNumber spot, strike, rate, expiry, log_spot, discount;
+        std::vector<AadNumber> volatilities, drifts, diffusions;
+        std::vector<double> adjoints;  // [payoff][stride]
+        std::vector<int> outputs;      // node of each payoff's discounted value on the current path
+};
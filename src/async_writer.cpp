@@ -0,0 +1,70 @@
+#include "async_writer.h"
+
+#include <algorithm>  // for std::max
+#include <utility>    // for std::move, std::swap
+
+/**
+ * Implementation of the background output stage
+ */
+
+AsyncWriter::AsyncWriter(std::size_t max_jobs)
+    : capacity(std::max<std::size_t>(max_jobs, 1)), worker(&AsyncWriter::run, this) { }
+
+AsyncWriter::~AsyncWriter() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return jobs.empty(); });
+        stopping = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+void AsyncWriter::submit(std::function<void()> job) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return jobs.size() < capacity; });
+        jobs.push_back(std::move(job));
+    }
+    changed.notify_all();
+}
+
+void AsyncWriter::flush() {
+    std::exception_ptr first_error;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return jobs.empty(); });
+        std::swap(first_error, error);
+    }
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+}
+
+/**
+ * Writer thread: runs the front job outside the lock and only pops it once it
+ * has finished, so an empty queue means every submitted job is done
+ */
+void AsyncWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) return;  // stopping with nothing left to write
+
+        std::function<void()> job = std::move(jobs.front());
+        lock.unlock();
+        std::exception_ptr job_error;
+        try {
+            job();
+        } catch (...) {
+            job_error = std::current_exception();
+        }
+        lock.lock();
+
+        if (job_error && !error) {
+            error = job_error;
+        }
+        jobs.pop_front();
+        changed.notify_all();
+    }
+}
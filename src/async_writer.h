@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>  // for std::condition_variable
+#include <cstddef>             // for std::size_t
+#include <deque>               // for std::deque
+#include <exception>           // for std::exception_ptr
+#include <functional>          // for std::function
+#include <mutex>               // for std::mutex
+#include <thread>              // for std::thread
+
+/**
+ * Background output stage
+ *
+ * Output jobs (serializing and writing results) run on one dedicated writer
+ * thread, in submission order, so the results of one run are written while
+ * the next run simulates. The queue is bounded: with the default capacity of
+ * two, one job can be writing while the next one waits (double buffering),
+ * and a producer that gets further ahead blocks in submit() instead of
+ * piling up snapshots in memory.
+ *
+ * A job reports failure by throwing. The first error is kept and rethrown by
+ * flush(), and later jobs still run. Jobs must own (or outlive) the data they
+ * write, since the submitting thread moves on immediately.
+ */
+class AsyncWriter {
+    public:
+        /**
+         * Starts the writer thread
+         *
+         * @param capacity Maximum number of jobs queued or running at once (at least 1)
+         */
+        explicit AsyncWriter(std::size_t capacity = 2);
+
+        /**
+         * Waits for every submitted job and stops the writer thread
+         * Errors not collected by flush() are discarded, so call flush() first
+         */
+        ~AsyncWriter();
+
+        AsyncWriter(const AsyncWriter&) = delete;
+        AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+        /**
+         * Queues a job, blocking while the queue is full
+         *
+         * @param job Output work to run on the writer thread
+         */
+        void submit(std::function<void()> job);
+
+        /**
+         * Waits until every submitted job has finished
+         * Rethrows the first exception thrown by a job since the last flush
+         */
+        void flush();
+
+    private:
+        std::size_t capacity;
+        std::deque<std::function<void()>> jobs;  // pending jobs; the front one may be running
+        bool stopping = false;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable changed;  // signalled on every submit, job completion and stop
+        std::thread worker;
+
+        void run();
+};
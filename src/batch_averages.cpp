@@ -0,0 +1,38 @@
+#include "batch_averages.h"
+
+#include <algorithm>  // for std::max, std::min
+#include <cmath>      // for std::sqrt
+#include <cstddef>    // for std::size_t
+
+/**
+ * Implementation of the incremental batch averages
+ */
+
+BatchLayout::BatchLayout(int num_paths) {
+    int target_lines;
+    if (num_paths <= 100) {
+        target_lines = num_paths;  // Show all paths for very small datasets
+    } else {
+        // Scale using square root: more paths = more lines, but not linearly
+        target_lines = std::max(15, std::min(50, (int)std::sqrt(num_paths)));
+    }
+    batch_size = std::max(1, num_paths / std::max(1, target_lines));
+    num_batches = (num_paths + batch_size - 1) / batch_size;
+}
+
+void BatchAccumulator::reset(const BatchLayout& layout, int first_path, int end_path, int num_steps) {
+    first = layout.batch_of(first_path);
+    span = end_path > first_path ? layout.batch_of(end_path - 1) - first + 1 : 0;
+    steps = num_steps;
+    sums.assign(static_cast<std::size_t>(steps) * span, 0.0);
+}
+
+void BatchAccumulator::merge_into(std::vector<double>& totals, int num_batches) const {
+    for (int step = 0; step < steps; step++) {
+        const double* source = &sums[static_cast<std::size_t>(step) * span];
+        double* target = &totals[static_cast<std::size_t>(step) * num_batches + first];
+        for (int b = 0; b < span; b++) {
+            target[b] += source[b];
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <vector>   // for std::vector
+
+/**
+ * Averaged paths for visualization, accumulated while the paths are simulated
+ *
+ * The plot shows one line per batch of consecutive paths (the average of
+ * the batch at every time step) rather than every path. Instead of storing
+ * all paths and averaging them afterwards, each chunk of paths adds its
+ * prices to a small [step][batch] accumulator covering only the batches the
+ * chunk overlaps. The chunk accumulators are merged in chunk order, like the
+ * payoff partials, so the averages do not depend on the thread count. The
+ * export then costs O(steps x batches) memory and no second pass over the
+ * paths.
+ */
+
+/**
+ * Assignment of paths to batches: contiguous runs of equal size, the last one possibly shorter
+ */
+class BatchLayout {
+    public:
+        BatchLayout() = default;
+
+        /**
+         * Sizes the batches for a path budget
+         * The number of lines grows with the square root of the number of paths,
+         * from 15 to 50; up to 100 paths every path is its own batch
+         *
+         * @param num_paths Number of paths that may be simulated
+         */
+        explicit BatchLayout(int num_paths);
+
+        int batch_of(int path) const { return path / batch_size; }
+        int first_path(int batch) const { return batch * batch_size; }
+        int size() const { return num_batches; }
+
+    private:
+        int batch_size = 1;
+        int num_batches = 0;
+};
+
+/**
+ * Per-batch price sums of one chunk of paths, laid out [step][batch - first_batch()]
+ */
+class BatchAccumulator {
+    public:
+        /**
+         * Clears the sums for a new range of paths, keeping the allocated buffer
+         *
+         * @param layout Batch assignment
+         * @param first_path First path of the range
+         * @param end_path One past the last path of the range
+         * @param num_steps Time steps per path
+         */
+        void reset(const BatchLayout& layout, int first_path, int end_path, int num_steps);
+
+        /**
+         * Sums of one time step, indexed by batch - first_batch()
+         */
+        double* row(int step) { return &sums[static_cast<std::size_t>(step) * span]; }
+
+        int first_batch() const { return first; }
+
+        /**
+         * Adds the sums to a [step][batch] table covering every batch
+         *
+         * @param totals Table of num_steps x num_batches sums
+         * @param num_batches Number of batches in the layout
+         */
+        void merge_into(std::vector<double>& totals, int num_batches) const;
+
+    private:
+        int first = 0;  // first batch overlapped by the range
+        int span = 0;   // number of batches overlapped
+        int steps = 0;
+        std::vector<double> sums;
+};
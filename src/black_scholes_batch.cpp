@@ -0,0 +1,129 @@
+#include "black_scholes_batch.h"
+#include "fast_math.h"
+#include "simd.h"
+
+#include <algorithm>  // for std::copy, std::min
+#include <cmath>      // for std::sqrt, std::exp, std::log
+
+/**
+ * Implementation of the batch Black-Scholes pricer
+ */
+
+namespace {
+
+constexpr int BLOCK_OPTIONS = 2048;  // options per parallel work item
+constexpr int TILE_OPTIONS = 64;     // options per local output tile
+constexpr int NUM_COLUMNS = 10;      // prices and greeks per option
+
+/**
+ * Output columns offset to the first option of a block
+ */
+struct GreekColumns {
+    double *call, *put, *call_delta, *put_delta, *gamma, *vega, *call_theta, *put_theta, *call_rho, *put_rho;
+};
+
+/**
+ * Shared terms of one expiry slice
+ */
+struct SliceTerms {
+    double log_spot;
+    double spot;
+    double rate;
+    double expiry;
+    double sqrt_expiry;
+    double discount;  // e^(-rT)
+};
+
+/**
+ * Prices a run of options of one expiry
+ * Uses Phi(-d) directly for puts instead of 1 - Phi(d), so deep
+ * out-of-the-money puts keep their relative accuracy.
+ * The loop writes into a local [column][option] tile that is copied out
+ * afterwards: ten output columns that may alias the inputs would need more
+ * runtime overlap checks than the compiler is willing to emit, and the
+ * loop would stay scalar
+ */
+SIMD_DISPATCH
+void price_block(const SliceTerms& slice, const double* K, const double* sigma, int n, const GreekColumns& out) {
+    const double S = slice.spot;
+    const double r = slice.rate;
+    const double T = slice.expiry;
+    const double log_spot = slice.log_spot;
+    const double sqrt_expiry = slice.sqrt_expiry;
+    const double discount = slice.discount;
+    double* columns[NUM_COLUMNS] = {out.call, out.put, out.call_delta, out.put_delta, out.gamma,
+                                    out.vega, out.call_theta, out.put_theta, out.call_rho, out.put_rho};
+    alignas(64) double tile[NUM_COLUMNS][TILE_OPTIONS];
+
+    for (int first = 0; first < n; first += TILE_OPTIONS) {
+        int count = std::min(TILE_OPTIONS, n - first);
+        const double* strike = K + first;
+        const double* vol = sigma + first;
+        for (int i = 0; i < count; i++) {
+            double vol_sqrt_t = vol[i] * sqrt_expiry;
+            double d1 = (log_spot - fast_log(strike[i]) + (r + 0.5 * vol[i] * vol[i]) * T) / vol_sqrt_t;
+            double d2 = d1 - vol_sqrt_t;
+            double cdf_d1, cdf_minus_d1, cdf_d2, cdf_minus_d2;
+            fast_norm_cdf_pair(d1, cdf_d1, cdf_minus_d1);
+            fast_norm_cdf_pair(d2, cdf_d2, cdf_minus_d2);
+            double pdf_d1 = fast_norm_pdf(d1);
+            double discounted_strike = strike[i] * discount;
+            double time_decay = -S * pdf_d1 * vol[i] / (2.0 * sqrt_expiry);
+
+            tile[0][i] = S * cdf_d1 - discounted_strike * cdf_d2;               // call
+            tile[1][i] = discounted_strike * cdf_minus_d2 - S * cdf_minus_d1;   // put
+            tile[2][i] = cdf_d1;                                                // call delta
+            tile[3][i] = -cdf_minus_d1;                                         // put delta
+            tile[4][i] = pdf_d1 / (S * vol_sqrt_t);                             // gamma
+            tile[5][i] = S * pdf_d1 * sqrt_expiry;                              // vega
+            tile[6][i] = time_decay - r * discounted_strike * cdf_d2;           // call theta
+            tile[7][i] = time_decay + r * discounted_strike * cdf_minus_d2;     // put theta
+            tile[8][i] = T * discounted_strike * cdf_d2;                        // call rho
+            tile[9][i] = -T * discounted_strike * cdf_minus_d2;                 // put rho
+        }
+        for (int c = 0; c < NUM_COLUMNS; c++) {
+            std::copy(tile[c], tile[c] + count, columns[c] + first);
+        }
+    }
+}
+
+}  // namespace
+
+void OptionChain::add_slice(double expiry, const std::vector<double>& slice_strikes, const std::vector<double>& slice_vols) {
+    expiries.push_back(expiry);
+    strikes.insert(strikes.end(), slice_strikes.begin(), slice_strikes.end());
+    volatilities.insert(volatilities.end(), slice_vols.begin(), slice_vols.end());
+    slice_start.push_back(static_cast<int>(strikes.size()));
+}
+
+void BsGreeks::resize(std::size_t n) {
+    for (std::vector<double>* column : {&call, &put, &call_delta, &put_delta, &gamma, &vega,
+                                        &call_theta, &put_theta, &call_rho, &put_rho}) {
+        column->resize(n);
+    }
+}
+
+void black_scholes_chain(const OptionChain& chain, BsGreeks& out) {
+    out.resize(chain.size());
+
+    // Work items: (slice, first option, end) blocks that never straddle two expiries
+    struct Block { int slice; int begin; int end; };
+    std::vector<Block> blocks;
+    for (int e = 0; e < static_cast<int>(chain.expiries.size()); e++) {
+        for (int i = chain.slice_start[e]; i < chain.slice_start[e + 1]; i += BLOCK_OPTIONS) {
+            blocks.push_back({e, i, std::min(i + BLOCK_OPTIONS, chain.slice_start[e + 1])});
+        }
+    }
+
+    double log_spot = std::log(chain.spot);
+    #pragma omp parallel for schedule(dynamic) if(blocks.size() > 1)
+    for (std::size_t b = 0; b < blocks.size(); b++) {
+        const Block& block = blocks[b];
+        double T = chain.expiries[block.slice];
+        SliceTerms slice = {log_spot, chain.spot, chain.rate, T, std::sqrt(T), std::exp(-chain.rate * T)};
+        int i = block.begin;
+        GreekColumns columns = {&out.call[i], &out.put[i], &out.call_delta[i], &out.put_delta[i], &out.gamma[i],
+                                &out.vega[i], &out.call_theta[i], &out.put_theta[i], &out.call_rho[i], &out.put_rho[i]};
+        price_block(slice, &chain.strikes[i], &chain.volatilities[i], block.end - i, columns);
+    }
+}
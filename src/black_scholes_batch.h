@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <vector>   // for std::vector
+
+/**
+ * Struct-of-arrays Black-Scholes pricing and greeks for whole option chains
+ *
+ * A chain is a set of expiry slices over one underlying. Terms that depend
+ * only on the expiry (sqrt(T), the discount factor, the drift) are computed
+ * once per slice, and ln(S) once per chain; the per-option loop then runs
+ * across strikes with the branch-free exp/log/normal CDF of fast_math.h, so
+ * it vectorizes to the widest SIMD unit available at runtime. Prices agree
+ * with black_scholes_call/black_scholes_put to about 1e-12 relative.
+ */
+
+struct OptionChain {
+    double spot = 0.0;
+    double rate = 0.0;
+    std::vector<double> expiries;      // one per slice
+    std::vector<int> slice_start = {0};  // options of slice e are [slice_start[e], slice_start[e + 1])
+    std::vector<double> strikes;       // per option, grouped by slice
+    std::vector<double> volatilities;  // per option
+
+    /**
+     * Appends the options of one expiry
+     *
+     * @param expiry Time to expiration of the slice
+     * @param slice_strikes Strike of each option
+     * @param slice_vols Volatility of each option (same length)
+     */
+    void add_slice(double expiry, const std::vector<double>& slice_strikes, const std::vector<double>& slice_vols);
+
+    std::size_t size() const { return strikes.size(); }
+};
+
+/**
+ * Prices and greeks of every option in a chain, one column per quantity
+ * Greeks are per unit change of the input (vega per 1.0 of volatility,
+ * theta per year, rho per 1.0 of rate)
+ */
+struct BsGreeks {
+    std::vector<double> call, put;
+    std::vector<double> call_delta, put_delta;
+    std::vector<double> gamma;  // same for calls and puts
+    std::vector<double> vega;   // same for calls and puts
+    std::vector<double> call_theta, put_theta;
+    std::vector<double> call_rho, put_rho;
+
+    void resize(std::size_t n);
+};
+
+/**
+ * Prices every option of a chain and computes its greeks
+ * Large chains are split into blocks spread over the OpenMP thread team
+ *
+ * @param chain Options to price
+ * @param out Output columns, resized to chain.size()
+ */
+void black_scholes_chain(const OptionChain& chain, BsGreeks& out);
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <vector>  // for std::vector
+
+#include "greeks.h"  // for Greek
+#include "payoff.h"
+
+/**
+ * Bump-and-revalue greeks with common random numbers
+ *
+ * Every path is simulated once per market scenario: the base case, spot
+ * up/down, volatility up/down, rate up/down and one day less to expiry.
+ * All scenarios are driven by the same normals. They are drawn once per
+ * block, and a fused kernel advances every scenario from them in one loop.
+ * Because the scenarios share their randomness, the noise mostly cancels in
+ * the finite differences. With independent reruns the difference of two
+ * prices is instead dominated by the Monte Carlo error of each run. The
+ * base scenario reproduces the priced paths bit for bit, so the finite
+ * differences are taken exactly relative to the reported price.
+ *
+ * Unlike the same-pass estimators of greeks.h this works for any payoff the
+ * engine prices, at the cost of simulating every scenario. Each path (or
+ * antithetic pair) contributes one finite-difference sample per greek, so
+ * every greek comes with a standard error. Estimates are discounted, since
+ * the scenarios differ in their discount factors.
+ */
+
+enum class BumpScenario {
+    Base,
+    SpotUp,
+    SpotDown,
+    VolUp,
+    VolDown,
+    RateUp,
+    RateDown,
+    ExpiryDown  // one bump closer to expiration (theta)
+};
+
+/**
+ * Bump sizes; central differences for delta, gamma, vega and rho, a forward step in time for theta
+ */
+struct BumpSizes {
+    double spot = 0.01;          // relative to the spot price
+    double volatility = 0.01;    // absolute
+    double rate = 0.001;         // absolute
+    double expiry = 1.0 / 365.0;  // years, at most half the time to expiration
+};
+
+/**
+ * Market scenarios of one contract and the fused kernel that simulates them
+ * Per-lane state is laid out [scenario][stride], stride >= the lanes of a block
+ */
+class BumpScenarios {
+    public:
+        static constexpr int NUM_SCENARIOS = 8;
+
+        BumpScenarios() = default;
+
+        /**
+         * @param spot Spot price
+         * @param rate Risk-free interest rate
+         * @param volatility Volatility
+         * @param expiry Time to expiration
+         * @param num_steps Steps per path (1 for exact terminal sampling)
+         * @param sizes Bump sizes
+         */
+        BumpScenarios(double spot, double rate, double volatility, double expiry, int num_steps,
+                      const BumpSizes& sizes = BumpSizes());
+
+        /**
+         * Starts every scenario of a block at its spot price
+         *
+         * @param log_prices Output log spot of every scenario and lane
+         * @param price_sums Running price sums to clear (may be null)
+         * @param stride Lanes reserved per scenario
+         */
+        void start(double* log_prices, double* price_sums, int stride) const;
+
+        /**
+         * Advances every scenario through consecutive steps driven by the same normals
+         *
+         * @param log_prices Log price of every scenario and lane, updated in place
+         * @param price_sums Running sums of the prices after each step (may be null)
+         * @param Z Normals laid out [step][lane], shared by all scenarios
+         * @param lanes Number of paths in the block
+         * @param stride Lanes reserved per scenario
+         * @param steps Number of steps to advance
+         */
+        void advance(double* log_prices, double* price_sums, const double* Z, int lanes, int stride, int steps) const;
+
+        /**
+         * Turns the log prices into terminal prices and the running sums into average prices
+         *
+         * @param log_prices Log prices, replaced by prices
+         * @param price_sums Running sums over num_steps steps, replaced by averages (may be null)
+         * @param lanes Number of paths in the block
+         * @param stride Lanes reserved per scenario
+         */
+        void finish(double* log_prices, double* price_sums, int lanes, int stride) const;
+
+        double discount(BumpScenario scenario) const { return discounts[static_cast<int>(scenario)]; }
+        double spot_bump() const { return spot_shift; }
+        double volatility_bump() const { return volatility_shift; }
+        double rate_bump() const { return rate_shift; }
+        double expiry_bump() const { return expiry_shift; }
+
+    private:
+        int steps = 1;
+        double log_spots[NUM_SCENARIOS] = {};
+        double drifts[NUM_SCENARIOS] = {};      // per step
+        double diffusions[NUM_SCENARIOS] = {};  // per step
+        double discounts[NUM_SCENARIOS] = {};
+        double spot_shift = 0.0;
+        double volatility_shift = 0.0;
+        double rate_shift = 0.0;
+        double expiry_shift = 0.0;
+};
+
+/**
+ * Running statistics of the finite-difference delta, gamma, vega, rho and theta of every payoff in a set
+ */
+class BumpReduction {
+    public:
+        static constexpr int NUM_GREEKS = 5;  // Greek::Delta through Greek::Theta
+
+        BumpReduction() = default;
+
+        /**
+         * Clears all statistics for a new run, keeping the allocated buffers
+         *
+         * @param payoffs Payoff set to differentiate
+         * @param scenarios Scenarios the paths are simulated under
+         */
+        void reset(const std::vector<Payoff>& payoffs, const BumpScenarios& scenarios);
+
+        /**
+         * Adds the finite differences of a block of paths
+         *
+         * @param payoffs The payoff set this reduction was reset for
+         * @param terminal Terminal prices, [scenario][stride]
+         * @param average Average prices in the same layout (may be null if no payoff is path-dependent)
+         * @param stride Lanes reserved per scenario
+         * @param n Number of paths in the block
+         */
+        void add(const std::vector<Payoff>& payoffs, const double* terminal, const double* average, int stride, int n);
+
+        /**
+         * Adds a block of antithetic path pairs, one sample per pair
+         * (each scenario row laid out as in PayoffReduction::add_antithetic)
+         */
+        void add_antithetic(const std::vector<Payoff>& payoffs, const double* terminal, const double* average,
+                            int stride, int pairs);
+
+        /**
+         * Merges another partial reduction into this one
+         *
+         * @param other Reduction over a disjoint set of paths
+         */
+        void merge(const BumpReduction& other);
+
+        /**
+         * Discounted estimate and standard error of one greek
+         *
+         * @param i Index of the payoff in the set
+         * @param greek Sensitivity to report
+         */
+        double mean(int i, Greek greek) const { return stats[i * NUM_GREEKS + static_cast<int>(greek)].mean; }
+        double std_error(int i, Greek greek) const;
+
+    private:
+        BumpScenarios scenarios;
+        std::vector<RunningStats> stats;  // [payoff * NUM_GREEKS + greek]
+        std::vector<double> values;       // [scenario][EVAL_CHUNK] payoffs, then [greek][EVAL_CHUNK] samples
+
+        void add_block(const std::vector<Payoff>& payoffs, const double* terminal, const double* average,
+                       int stride, int offset, int n, int mirror_offset);
+};
@@ -0,0 +1,140 @@
+#include "column_writer.h"
+
+#include <charconv>   // for std::to_chars
+#include <cstring>    // for std::memcpy
+#include <fstream>    // for std::ofstream
+#include <stdexcept>  // for std::runtime_error
+
+/**
+ * Implementation of the columnar writer
+ */
+
+namespace {
+
+constexpr char MAGIC[8] = {'M', 'C', 'C', 'O', 'L', 'U', 'M', 'N'};
+constexpr std::uint32_t VERSION = 1;
+constexpr std::size_t HEADER_BYTES = 24;
+constexpr std::size_t DESCRIPTOR_BYTES = 64;
+
+/**
+ * Appends an unsigned integer to a byte buffer in little-endian order, whatever the host order
+ */
+template <typename UInt>
+void put_le(std::vector<char>& out, UInt value) {
+    for (std::size_t i = 0; i < sizeof(UInt); i++) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * Appends a column's values in the stored precision, little-endian
+ */
+template <typename Float, typename Bits>
+void put_values(std::vector<char>& out, const std::vector<double>& values) {
+    static_assert(sizeof(Float) == sizeof(Bits), "bit pattern must match the float width");
+    std::size_t first = out.size();
+    out.resize(first + values.size() * sizeof(Float));
+    char* dest = out.data() + first;
+    for (std::size_t i = 0; i < values.size(); i++) {
+        Float value = static_cast<Float>(values[i]);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(Bits));
+        for (std::size_t b = 0; b < sizeof(Bits); b++) {
+            dest[i * sizeof(Float) + b] = static_cast<char>((bits >> (8 * b)) & 0xFF);
+        }
+#else
+        std::memcpy(dest + i * sizeof(Float), &value, sizeof(Float));
+#endif
+    }
+}
+
+std::size_t align_up(std::size_t offset, std::size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+std::size_t value_bytes(ColumnType type) {
+    return type == ColumnType::Float32 ? sizeof(float) : sizeof(double);
+}
+
+}  // namespace
+
+void ColumnWriter::add_column(const std::string& name, std::vector<double> values, ColumnType type) {
+    if (name.size() > static_cast<std::size_t>(MAX_NAME_LENGTH)) {
+        throw std::runtime_error("column name too long: " + name);
+    }
+    if (!columns.empty() && values.size() != rows()) {
+        throw std::runtime_error("column " + name + " has " + std::to_string(values.size()) +
+                                 " rows, expected " + std::to_string(rows()));
+    }
+    columns.push_back({name, type, std::move(values)});
+}
+
+void ColumnWriter::write_binary(const std::string& path) const {
+    std::vector<char> bytes;
+    bytes.insert(bytes.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    put_le<std::uint32_t>(bytes, VERSION);
+    put_le<std::uint32_t>(bytes, static_cast<std::uint32_t>(columns.size()));
+    put_le<std::uint64_t>(bytes, rows());
+
+    // Column offsets follow from the header, the descriptors and the padded sizes of earlier columns
+    std::size_t offset = align_up(HEADER_BYTES + columns.size() * DESCRIPTOR_BYTES, ALIGNMENT);
+    std::vector<std::size_t> offsets;
+    for (const Column& column : columns) {
+        offsets.push_back(offset);
+        offset = align_up(offset + rows() * value_bytes(column.type), ALIGNMENT);
+    }
+
+    for (std::size_t c = 0; c < columns.size(); c++) {
+        char name[MAX_NAME_LENGTH + 1] = {};
+        std::memcpy(name, columns[c].name.data(), columns[c].name.size());
+        bytes.insert(bytes.end(), name, name + sizeof(name));
+        put_le<std::uint32_t>(bytes, static_cast<std::uint32_t>(columns[c].type));
+        put_le<std::uint32_t>(bytes, 0);
+        put_le<std::uint64_t>(bytes, offsets[c]);
+    }
+
+    bytes.reserve(offset);
+    for (std::size_t c = 0; c < columns.size(); c++) {
+        bytes.resize(offsets[c], 0);
+        if (columns[c].type == ColumnType::Float32) {
+            put_values<float, std::uint32_t>(bytes, columns[c].values);
+        } else {
+            put_values<double, std::uint64_t>(bytes, columns[c].values);
+        }
+    }
+    bytes.resize(offset, 0);
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw std::runtime_error("cannot write " + path);
+    }
+}
+
+void ColumnWriter::write_text(const std::string& path) const {
+    std::string text;
+    for (std::size_t c = 0; c < columns.size(); c++) {
+        text += columns[c].name;
+        text += c + 1 < columns.size() ? ',' : '\n';
+    }
+
+    // Shortest representation that reads back to the stored value
+    char buffer[32];
+    for (std::size_t r = 0; r < rows(); r++) {
+        for (std::size_t c = 0; c < columns.size(); c++) {
+            double value = columns[c].values[r];
+            std::to_chars_result result = columns[c].type == ColumnType::Float32
+                ? std::to_chars(buffer, buffer + sizeof(buffer), static_cast<float>(value))
+                : std::to_chars(buffer, buffer + sizeof(buffer), value);
+            text.append(buffer, result.ptr);
+            text += c + 1 < columns.size() ? ',' : '\n';
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (!file) {
+        throw std::runtime_error("cannot write " + path);
+    }
+}
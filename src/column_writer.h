@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint32_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+/**
+ * Columnar export of simulation output
+ *
+ * A table of equally long, named numeric columns is written either as a
+ * binary file that readers can memory-map, or as CSV text formatted with
+ * std::to_chars (shortest round-trip representation, no locale, no stream
+ * formatting state).
+ *
+ * Binary layout, all integers and values little-endian:
+ *   offset 0   header (24 bytes)
+ *              char     magic[8]      "MCCOLUMN"
+ *              uint32   version       1
+ *              uint32   num_columns
+ *              uint64   num_rows
+ *   offset 24  one descriptor per column (64 bytes each)
+ *              char     name[48]      NUL-padded UTF-8
+ *              uint32   type          0 = float64, 1 = float32
+ *              uint32   reserved      0
+ *              uint64   offset        byte offset of the column data from the start of the file
+ *   then the column data, each column contiguous and starting on a 64-byte
+ *   boundary (the buffer alignment Arrow uses), padded with zeros
+ *
+ * The type is per column, and columns of one file may differ, so readers
+ * take each column's dtype from its descriptor. The simulator's dist/Data.bin
+ * holds a float64 "time_step" column (step indices 0 .. num_rows - 1), then
+ * one "avg_paths_<first>-<last>" column per batch of paths, float64, or
+ * float32 with single-precision path storage.
+ *
+ * A column can therefore be read without parsing, e.g. in numpy with
+ * np.memmap(path, dtype='<f8' if type == 0 else '<f4', mode='r', offset=offset, shape=(num_rows,)).
+ */
+
+enum class ColumnType : std::uint32_t {
+    Float64 = 0,
+    Float32 = 1
+};
+
+class ColumnWriter {
+    public:
+        static constexpr int MAX_NAME_LENGTH = 47;  // bytes, excluding the terminating NUL
+        static constexpr int ALIGNMENT = 64;        // column data alignment in bytes
+
+        /**
+         * Appends a column; every column must have the same number of rows
+         * Throws std::runtime_error if the name is too long or the length differs
+         *
+         * @param name Column name (at most MAX_NAME_LENGTH bytes)
+         * @param values Column values
+         * @param type Stored precision
+         */
+        void add_column(const std::string& name, std::vector<double> values, ColumnType type = ColumnType::Float64);
+
+        /**
+         * Writes the table in the binary layout above
+         * Throws std::runtime_error if the file cannot be written
+         *
+         * @param path Output file
+         */
+        void write_binary(const std::string& path) const;
+
+        /**
+         * Writes the table as CSV, a header row of names followed by one line per row
+         * Throws std::runtime_error if the file cannot be written
+         *
+         * @param path Output file
+         */
+        void write_text(const std::string& path) const;
+
+        std::size_t rows() const { return columns.empty() ? 0 : columns[0].values.size(); }
+
+    private:
+        struct Column {
+            std::string name;
+            ColumnType type;
+            std::vector<double> values;
+        };
+        std::vector<Column> columns;
+};
@@ -0,0 +1,70 @@
+#include "control_variate.h"
+
+#include <algorithm>  // for std::max, std::swap
+#include <cmath>      // for std::sqrt, std::fabs
+
+/**
+ * Implementation of the control-variate estimator
+ */
+
+namespace {
+
+/**
+ * Solves A x = b for a small dense system by Gaussian elimination with
+ * partial pivoting; A is row-major m x m. Returns false if A is singular.
+ */
+bool solve(std::vector<double> A, std::vector<double>& b, int m) {
+    for (int col = 0; col < m; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < m; row++) {
+            if (std::fabs(A[row * m + col]) > std::fabs(A[pivot * m + col])) pivot = row;
+        }
+        if (std::fabs(A[pivot * m + col]) < 1e-300) return false;
+        if (pivot != col) {
+            for (int k = 0; k < m; k++) std::swap(A[col * m + k], A[pivot * m + k]);
+            std::swap(b[col], b[pivot]);
+        }
+        for (int row = col + 1; row < m; row++) {
+            double factor = A[row * m + col] / A[col * m + col];
+            for (int k = col; k < m; k++) A[row * m + k] -= factor * A[col * m + k];
+            b[row] -= factor * b[col];
+        }
+    }
+    for (int row = m - 1; row >= 0; row--) {
+        for (int k = row + 1; k < m; k++) b[row] -= A[row * m + k] * b[k];
+        b[row] /= A[row * m + row];
+    }
+    return true;
+}
+
+}  // namespace
+
+Estimate control_variate_estimate(const PayoffReduction& reduction, int target,
+                                  const std::vector<int>& controls, const std::vector<double>& expected) {
+    Estimate plain{reduction.mean(target), reduction.std_error(target)};
+    int m = controls.size();
+    long N = reduction.count();
+    if (m == 0 || N < 2) return plain;
+
+    // Optimal beta from the sample covariances of the same paths
+    std::vector<double> cov_xx(m * m);
+    std::vector<double> beta(m);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+            cov_xx[i * m + j] = reduction.covariance(controls[i], controls[j]);
+        }
+        beta[i] = reduction.covariance(controls[i], target);
+    }
+    std::vector<double> cov_xy = beta;
+    if (!solve(cov_xx, beta, m)) return plain;
+
+    double mean = reduction.mean(target);
+    double explained = 0.0;  // beta . Cov(X, Y)
+    for (int i = 0; i < m; i++) {
+        mean -= beta[i] * (reduction.mean(controls[i]) - expected[i]);
+        explained += beta[i] * cov_xy[i];
+    }
+
+    double residual_variance = std::max(reduction.variance(target) - explained, 0.0);
+    return {mean, std::sqrt(residual_variance / N)};
+}
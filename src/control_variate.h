@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>  // for std::vector
+
+#include "payoff.h"
+
+/**
+ * Control-variate estimation on top of a payoff reduction
+ *
+ * If controls X_1..X_m with known expectations E[X] are simulated on the
+ * same paths as the target Y, then
+ *   Y_cv = mean(Y) - beta . (mean(X) - E[X]),   beta = Cov(X, X)^-1 Cov(X, Y)
+ * is still unbiased (up to the O(1/N) bias of estimating beta from the same
+ * sample) and its variance is Var(Y) * (1 - R^2), where R^2 is the fraction
+ * of Y's variance explained by the controls.
+ */
+
+struct Estimate {
+    double mean;       // estimated (undiscounted) expectation
+    double std_error;  // standard error of the estimate
+};
+
+/**
+ * Control-variate estimate of one payoff in a reduction
+ *
+ * @param reduction Reduction created with track_covariance
+ * @param target Index of the payoff to estimate
+ * @param controls Indices of the control payoffs
+ * @param expected Known expectation of each control (same order)
+ * @return Corrected mean and its standard error
+ */
+Estimate control_variate_estimate(const PayoffReduction& reduction, int target,
+                                  const std::vector<int>& controls, const std::vector<double>& expected);
@@ -0,0 +1,143 @@
+#include "greeks.h"
+#include "simd.h"
+
+#include <algorithm>  // for std::min
+#include <cmath>      // for std::sqrt
+
+/**
+ * Implementation of the same-pass greek estimators
+ */
+
+namespace {
+
+constexpr int EVAL_CHUNK = 64;  // paths evaluated per pass, as in PayoffReduction
+constexpr int NUM_GREEKS = GreekReduction::NUM_GREEKS;
+
+/**
+ * Writes the delta, gamma and vega samples of one payoff for paths [first, first + n)
+ * One branch per payoff, branch-free across paths
+ */
+SIMD_DISPATCH
+void evaluate_greeks(const Payoff& payoff, const GreekModel& model, const PathSensitivities& paths,
+                     int first, int n, double* delta, double* gamma, double* vega) {
+    const double s = model.spot;
+    const double sigma = model.volatility;
+    const double T = model.expiry;
+    const double K = payoff.strike;
+    const double* terminal = paths.terminal + first;
+    const double* W = paths.brownian + first;
+
+    switch (payoff.type) {
+        case PayoffType::Call:
+        case PayoffType::Put:
+        case PayoffType::Forward: {
+            // Pathwise delta and vega; gamma by likelihood ratio on the pathwise delta
+            bool is_put = payoff.type == PayoffType::Put;
+            bool is_forward = payoff.type == PayoffType::Forward;
+            for (int i = 0; i < n; i++) {
+                double exercised = is_forward ? 1.0 : is_put ? (terminal[i] < K ? -1.0 : 0.0) : (terminal[i] > K ? 1.0 : 0.0);
+                double weight = exercised * terminal[i];
+                delta[i] = weight / s;
+                vega[i] = weight * (W[i] - sigma * T);
+                // A forward is linear in S_0: its gamma is exactly zero
+                gamma[i] = is_forward ? 0.0 : weight / (s * s) * (W[i] / (sigma * T) - 1.0);
+            }
+            break;
+        }
+        case PayoffType::DigitalCall:
+        case PayoffType::DigitalPut: {
+            // Likelihood ratio: payoff times the score of the terminal density
+            bool is_call = payoff.type == PayoffType::DigitalCall;
+            for (int i = 0; i < n; i++) {
+                double paid = is_call ? (terminal[i] > K ? 1.0 : 0.0) : (terminal[i] < K ? 1.0 : 0.0);
+                double z2_minus_1 = W[i] * W[i] / T - 1.0;
+                delta[i] = paid * W[i] / (s * sigma * T);
+                gamma[i] = paid * (z2_minus_1 / (s * s * sigma * sigma * T) - W[i] / (s * s * sigma * T));
+                vega[i] = paid * (z2_minus_1 / sigma - W[i]);
+            }
+            break;
+        }
+        case PayoffType::AsianCall:
+        case PayoffType::AsianPut: {
+            // Pathwise through the average; the gamma's score only involves the first step's normal
+            bool is_call = payoff.type == PayoffType::AsianCall;
+            const double* average = paths.average + first;
+            const double* average_vega = paths.average_vega + first;
+            const double* first_normal = paths.first_normal + first;
+            double first_diffusion = sigma * std::sqrt(model.first_step);
+            for (int i = 0; i < n; i++) {
+                double exercised = is_call ? (average[i] > K ? 1.0 : 0.0) : (average[i] < K ? -1.0 : 0.0);
+                delta[i] = exercised * average[i] / s;
+                gamma[i] = exercised * average[i] / (s * s) * (first_normal[i] / first_diffusion - 1.0);
+                vega[i] = exercised * average_vega[i];
+            }
+            break;
+        }
+    }
+}
+
+}  // namespace
+
+GreekReduction::GreekReduction(const std::vector<Payoff>& payoffs, const GreekModel& greek_model) {
+    reset(payoffs, greek_model);
+}
+
+void GreekReduction::reset(const std::vector<Payoff>& payoffs, const GreekModel& greek_model) {
+    model = greek_model;
+    stats.assign(payoffs.size() * NUM_GREEKS, RunningStats{});
+    values.resize(2 * NUM_GREEKS * EVAL_CHUNK);
+}
+
+void GreekReduction::add(const std::vector<Payoff>& payoffs, const PathSensitivities& paths, int n) {
+    for (int i = 0; i < n; i += EVAL_CHUNK) {
+        add_block(payoffs, paths, i, std::min(EVAL_CHUNK, n - i), 0);
+    }
+}
+
+void GreekReduction::add_antithetic(const std::vector<Payoff>& payoffs, const PathSensitivities& paths, int pairs) {
+    for (int i = 0; i < pairs; i += EVAL_CHUNK) {
+        add_block(payoffs, paths, i, std::min(EVAL_CHUNK, pairs - i), pairs);
+    }
+}
+
+/**
+ * Evaluates the estimators of every payoff on one chunk of samples and
+ * merges their two-pass block statistics into the running totals
+ */
+void GreekReduction::add_block(const std::vector<Payoff>& payoffs, const PathSensitivities& paths,
+                               int offset, int n, int mirror_offset) {
+    double* v = values.data();                           // [greek][EVAL_CHUNK]
+    double* mirror = values.data() + NUM_GREEKS * EVAL_CHUNK;
+
+    for (std::size_t p = 0; p < payoffs.size(); p++) {
+        evaluate_greeks(payoffs[p], model, paths, offset, n, v, v + EVAL_CHUNK, v + 2 * EVAL_CHUNK);
+        if (mirror_offset > 0) {
+            evaluate_greeks(payoffs[p], model, paths, offset + mirror_offset, n,
+                            mirror, mirror + EVAL_CHUNK, mirror + 2 * EVAL_CHUNK);
+            for (int k = 0; k < NUM_GREEKS * EVAL_CHUNK; k++) {
+                v[k] = 0.5 * (v[k] + mirror[k]);
+            }
+        }
+
+        for (int g = 0; g < NUM_GREEKS; g++) {
+            const double* samples = v + g * EVAL_CHUNK;
+            double sum = 0.0;
+            for (int i = 0; i < n; i++) sum += samples[i];
+            double mean = sum / n;
+            double m2 = 0.0;
+            for (int i = 0; i < n; i++) m2 += (samples[i] - mean) * (samples[i] - mean);
+            stats[p * NUM_GREEKS + g].merge({n, mean, m2});
+        }
+    }
+}
+
+void GreekReduction::merge(const GreekReduction& other) {
+    for (std::size_t i = 0; i < stats.size(); i++) {
+        stats[i].merge(other.stats[i]);
+    }
+}
+
+double GreekReduction::std_error(int i, Greek greek) const {
+    const RunningStats& greek_stats = stats[i * NUM_GREEKS + static_cast<int>(greek)];
+    return greek_stats.count > 0 ? std::sqrt(greek_stats.variance() / greek_stats.count) : 0.0;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>  // for std::vector
+
+#include "payoff.h"
+
+/**
+ * Monte Carlo greeks estimated in the same pass as the prices
+ *
+ * Under GBM, S_T = S_0 exp((r - sigma^2/2)T + sigma W_T), so every path
+ * carries its own sensitivities and no bumped rerun is needed:
+ * - Pathwise estimators differentiate the payoff along the path:
+ *   dS_T/dS_0 = S_T/S_0 and dS_t/dsigma = S_t (W_t - sigma t). They have low
+ *   variance but need a payoff that is continuous in the price.
+ * - Likelihood-ratio estimators instead multiply the payoff by the
+ *   derivative of the log density of the path (the score), which works for
+ *   discontinuous payoffs such as digitals.
+ *
+ * Deltas and vegas of calls, puts, forwards and Asians are pathwise; their
+ * gammas apply the likelihood ratio to the pathwise delta (the mixed
+ * estimator, since the pathwise delta itself jumps at the strike). Digitals
+ * use likelihood-ratio estimators throughout. All estimates are
+ * undiscounted, like PayoffReduction means, and reduced with the same
+ * Welford/Chan statistics so every greek comes with a standard error.
+ */
+
+/**
+ * Market inputs the estimators differentiate with respect to
+ */
+struct GreekModel {
+    double spot = 0.0;
+    double rate = 0.0;
+    double volatility = 0.0;
+    double expiry = 0.0;
+    double first_step = 0.0;  // length of the first time step (score of path-dependent gammas)
+};
+
+/**
+ * Per-path inputs of the estimators for a block of paths
+ */
+struct PathSensitivities {
+    const double* terminal;      // S_T
+    const double* average;       // arithmetic average price (null if no payoff is path-dependent)
+    const double* brownian;      // W_T
+    const double* first_normal;  // standard normal of the first step (null if no payoff is path-dependent)
+    const double* average_vega;  // d(average)/dsigma (null if no payoff is path-dependent)
+};
+
+enum class Greek {
+    Delta,  // d price / d S_0
+    Gamma,  // d^2 price / d S_0^2
+    Vega,   // d price / d sigma
+    Rho,    // d price / d r (bump-and-revalue only)
+    Theta   // d price / d t = -d price / d T (bump-and-revalue only)
+};
+
+/**
+ * Running statistics of the delta, gamma and vega of every payoff in a set
+ */
+class GreekReduction {
+    public:
+        static constexpr int NUM_GREEKS = 3;
+
+        GreekReduction() = default;
+
+        /**
+         * @param payoffs Payoff set to differentiate
+         * @param model Market inputs of the simulation
+         */
+        GreekReduction(const std::vector<Payoff>& payoffs, const GreekModel& model);
+
+        /**
+         * Clears all statistics for a new run, keeping the allocated buffers
+         *
+         * @param payoffs Payoff set to differentiate
+         * @param model Market inputs of the simulation
+         */
+        void reset(const std::vector<Payoff>& payoffs, const GreekModel& model);
+
+        /**
+         * Adds the estimators of a block of paths
+         *
+         * @param payoffs The payoff set this reduction was created for
+         * @param paths Per-path inputs of the block
+         * @param n Number of paths in the block
+         */
+        void add(const std::vector<Payoff>& payoffs, const PathSensitivities& paths, int n);
+
+        /**
+         * Adds a block of antithetic path pairs, one sample per pair
+         * (same layout as PayoffReduction::add_antithetic)
+         *
+         * @param payoffs The payoff set this reduction was created for
+         * @param paths Per-path inputs: pairs primary paths, then their mirrored paths
+         * @param pairs Number of antithetic pairs in the block
+         */
+        void add_antithetic(const std::vector<Payoff>& payoffs, const PathSensitivities& paths, int pairs);
+
+        /**
+         * Merges another partial reduction into this one
+         *
+         * @param other Reduction over a disjoint set of paths
+         */
+        void merge(const GreekReduction& other);
+
+        /**
+         * Undiscounted estimate and standard error of one greek
+         *
+         * @param i Index of the payoff in the set
+         * @param greek Sensitivity to report
+         */
+        double mean(int i, Greek greek) const { return stats[i * NUM_GREEKS + static_cast<int>(greek)].mean; }
+        double std_error(int i, Greek greek) const;
+
+    private:
+        GreekModel model;
+        std::vector<RunningStats> stats;  // [payoff * NUM_GREEKS + greek]
+        std::vector<double> values;       // [greek][EVAL_CHUNK] scratch, then [greek][EVAL_CHUNK] of the mirrors
+
+        void add_block(const std::vector<Payoff>& payoffs, const PathSensitivities& paths,
+                       int offset, int n, int mirror_offset);
+};
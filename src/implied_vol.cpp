@@ -0,0 +1,153 @@
+#include "implied_vol.h"
+#include "fast_math.h"
+#include "simd.h"
+
+#include <algorithm>  // for std::min
+#include <cmath>      // for std::sqrt, std::exp, std::log, std::nan
+
+/**
+ * Implementation of the batch implied volatility solver
+ */
+
+namespace {
+
+constexpr int BLOCK_QUOTES = 2048;       // quotes per parallel work item
+constexpr int TILE_QUOTES = 64;          // quotes iterated together
+constexpr int MAX_ITERATIONS = 64;       // bisection alone reaches 1e-17 of MAX_TOTAL_VOL by then
+constexpr double MAX_TOTAL_VOL = 10.0;   // upper end of the initial bracket for sigma*sqrt(T)
+constexpr double TOLERANCE = 1e-13;      // relative step size at which a quote has converged
+
+/**
+ * Normalized state of one tile of quotes
+ */
+struct Tile {
+    alignas(64) double x[TILE_QUOTES];         // ln(F/K) of the out-of-the-money call, <= 0
+    alignas(64) double beta[TILE_QUOTES];      // its normalized price
+    alignas(64) double half_up[TILE_QUOTES];   // e^(x/2)
+    alignas(64) double half_down[TILE_QUOTES]; // e^(-x/2)
+    alignas(64) double s[TILE_QUOTES];         // current total volatility
+    alignas(64) double lo[TILE_QUOTES];        // bracket
+    alignas(64) double hi[TILE_QUOTES];
+    alignas(64) double valid[TILE_QUOTES];     // 1 if the price is inside the no-arbitrage bounds
+};
+
+/**
+ * Maps the quotes to normalized out-of-the-money prices and sets the initial guess
+ */
+SIMD_DISPATCH
+void prepare_tile(double log_forward, double discount, const double* K, const double* price, const double* call_flag,
+                  int n, Tile& tile) {
+    for (int i = 0; i < n; i++) {
+        double x = log_forward - fast_log(K[i]);
+        double up = fast_exp(0.5 * x);
+        double down = fast_exp(-0.5 * x);
+        double parity = up - down;  // normalized call minus put
+        // sqrt(F*K) = e^(log_forward) * e^(-x/2)
+        double normalized = price[i] / (discount * fast_exp(log_forward) * down);
+        double call = call_flag[i] != 0.0 ? normalized : normalized + parity;
+        bool call_is_otm = x <= 0.0;
+        double beta = call_is_otm ? call : call - parity;  // the out-of-the-money put, as a call at -x
+        double otm_x = call_is_otm ? x : -x;
+        double otm_up = call_is_otm ? up : down;
+        double otm_down = call_is_otm ? down : up;
+
+        // Prices in [0, e^(x/2)) are attainable by some volatility
+        bool ok = beta > 0.0 && beta < otm_up;
+        beta = ok ? beta : 0.5 * otm_up;  // harmless placeholder, discarded at the end
+
+        // Corrado-Miller guess with F and K scaled to e^(x/2) and e^(-x/2)
+        double forward_minus_strike = otm_up - otm_down;
+        double centred = beta - 0.5 * forward_minus_strike;
+        double radicand = centred * centred - forward_minus_strike * forward_minus_strike / 3.14159265358979323846;
+        double guess = 2.5066282746310002 / (otm_up + otm_down) * (centred + std::sqrt(radicand > 0.0 ? radicand : 0.0));
+        guess = guess > 1e-3 ? guess : std::sqrt(2.0 * -otm_x);  // inflection point when the guess degenerates
+        guess = guess > 1e-3 ? guess : 1e-3;
+
+        tile.x[i] = otm_x;
+        tile.beta[i] = beta;
+        tile.half_up[i] = otm_up;
+        tile.half_down[i] = otm_down;
+        tile.s[i] = guess < MAX_TOTAL_VOL ? guess : 0.5 * MAX_TOTAL_VOL;
+        tile.lo[i] = 0.0;
+        tile.hi[i] = MAX_TOTAL_VOL;
+        tile.valid[i] = ok ? 1.0 : 0.0;
+    }
+}
+
+/**
+ * One safeguarded Halley step for every quote of the tile
+ * With b(s) = e^(x/2) Phi(x/s + s/2) - e^(-x/2) Phi(x/s - s/2):
+ *   b'(s) = e^(x/2) phi(x/s + s/2),  b''(s) / b'(s) = x^2/s^3 - s/4
+ *
+ * @return Number of quotes that have not converged yet
+ */
+SIMD_DISPATCH
+int iterate_tile(Tile& tile, int n) {
+    int active = 0;
+    for (int i = 0; i < n; i++) {
+        double s = tile.s[i];
+        double x = tile.x[i];
+        double d1 = x / s + 0.5 * s;
+        double d2 = x / s - 0.5 * s;
+        double b = tile.half_up[i] * fast_norm_cdf(d1) - tile.half_down[i] * fast_norm_cdf(d2);
+        double vega = tile.half_up[i] * fast_norm_pdf(d1);
+        double f = b - tile.beta[i];
+
+        double lo = f < 0.0 ? s : tile.lo[i];
+        double hi = f > 0.0 ? s : tile.hi[i];
+        double newton = f / vega;
+        double step = newton / (1.0 - 0.5 * newton * (x * x / (s * s * s) - 0.25 * s));
+        double next = s - step;
+        // Outside the bracket (or NaN from a vanishing vega): bisect instead
+        next = next > lo && next < hi ? next : 0.5 * (lo + hi);
+
+        double change = next - s;
+        active += (change * change > TOLERANCE * TOLERANCE * s * s && hi - lo > TOLERANCE * s) ? 1 : 0;
+        tile.s[i] = next;
+        tile.lo[i] = lo;
+        tile.hi[i] = hi;
+    }
+    return active;
+}
+
+}  // namespace
+
+void implied_volatility_chain(const OptionChain& chain, const std::vector<double>& prices,
+                              const std::vector<bool>& is_call, std::vector<double>& vols) {
+    vols.resize(chain.size());
+
+    struct Block { int slice; int begin; int end; };
+    std::vector<Block> blocks;
+    for (int e = 0; e < static_cast<int>(chain.expiries.size()); e++) {
+        for (int i = chain.slice_start[e]; i < chain.slice_start[e + 1]; i += BLOCK_QUOTES) {
+            blocks.push_back({e, i, std::min(i + BLOCK_QUOTES, chain.slice_start[e + 1])});
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic) if(blocks.size() > 1)
+    for (std::size_t b = 0; b < blocks.size(); b++) {
+        const Block& block = blocks[b];
+        double T = chain.expiries[block.slice];
+        double log_forward = std::log(chain.spot) + chain.rate * T;
+        double discount = std::exp(-chain.rate * T);
+        double sqrt_expiry = std::sqrt(T);
+
+        Tile tile;
+        alignas(64) double call_flag[TILE_QUOTES];
+        for (int first = block.begin; first < block.end; first += TILE_QUOTES) {
+            int n = std::min(TILE_QUOTES, block.end - first);
+            for (int i = 0; i < n; i++) {
+                call_flag[i] = is_call[first + i] ? 1.0 : 0.0;
+            }
+            prepare_tile(log_forward, discount, &chain.strikes[first], &prices[first], call_flag, n, tile);
+
+            for (int iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
+                if (iterate_tile(tile, n) == 0) break;
+            }
+
+            for (int i = 0; i < n; i++) {
+                vols[first + i] = tile.valid[i] != 0.0 ? tile.s[i] / sqrt_expiry : std::nan("");
+            }
+        }
+    }
+}
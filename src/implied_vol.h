@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>  // for std::vector
+
+#include "black_scholes_batch.h"
+
+/**
+ * Batch implied volatilities for whole option chains
+ *
+ * Every quote is first mapped to Jaeckel's normalized form: with forward F,
+ * x = ln(F/K) and total volatility s = sigma*sqrt(T), the undiscounted price
+ * divided by sqrt(F*K) depends on (x, s) only. In-the-money quotes are turned
+ * into their out-of-the-money counterpart by put-call parity, which avoids
+ * solving on a price dominated by intrinsic value.
+ *
+ * Each quote then starts from the Corrado-Miller closed-form guess and runs
+ * Halley iterations (Newton with the vega derivative as second-order term)
+ * inside a bisection bracket, so a step that leaves the bracket falls back
+ * to bisection and the solve cannot diverge. Quotes are processed in tiles
+ * with the branch-free math of fast_math.h, so the iterations vectorize
+ * across quotes; a tile stops as soon as all of its quotes have converged.
+ */
+
+/**
+ * Solves the implied volatility of every quote of a chain
+ *
+ * @param chain Spot, rate, expiries and strikes of the quotes (chain.volatilities is ignored)
+ * @param prices Market price of each option
+ * @param is_call Whether each quote is a call (otherwise a put)
+ * @param vols Output implied volatilities, resized to chain.size(); NaN where the
+ *             price violates the no-arbitrage bounds
+ */
+void implied_volatility_chain(const OptionChain& chain, const std::vector<double>& prices,
+                              const std::vector<bool>& is_call, std::vector<double>& vols);
@@ -1,4 +1,5 @@
 #include "math.h"
+#include "simd.h"
 
 /**
  * Implementation of mathematical functions for Monte Carlo option pricing
@@ -21,6 +22,26 @@ double nextPrice(double S, double mu, double sigma, double dt, double Z) {
     return S * std::exp(drift + diffusion);
 }
 
+GbmStep make_gbm_step(double mu, double sigma, double dt) {
+    return {(mu - 0.5 * sigma * sigma) * dt, sigma * std::sqrt(dt)};
+}
+
+/**
+ * Batched GBM kernel: the inner loop runs across paths, so consecutive
+ * lanes share the same coefficients and the update is a single
+ * multiply-add per lane
+ */
+SIMD_DISPATCH
+void advance_log_prices(const GbmStep& step, double* log_prices, double* Z, int lanes, int steps) {
+    for (int k = 0; k < steps; k++) {
+        double* z_row = Z + static_cast<long>(k) * lanes;
+        for (int lane = 0; lane < lanes; lane++) {
+            log_prices[lane] += step.drift + step.diffusion * z_row[lane];
+            z_row[lane] = log_prices[lane];
+        }
+    }
+}
+
 /**
  * Calculates European Call option price using Monte Carlo method
  * Averages the discounted payoffs across all simulation paths
@@ -14,6 +14,7 @@
 /**
  * Calculates next asset price using geometric Brownian motion
  * S_next = S * exp((mu - 0.5*sigma^2)*dt + sigma*sqrt(dt)*Z)
+ * Scalar reference form; the simulator uses the batched advance_log_prices
  * 
  * @param S Current asset price
  * @param mu Interest rate (drift)
@@ -24,6 +25,38 @@
  */
 double nextPrice(double S, double mu, double sigma, double dt, double Z);
 
+/**
+ * Per-step coefficients of the log-space GBM update, computed once per run
+ * ln(S_next) = ln(S) + drift + diffusion*Z
+ */
+struct GbmStep {
+    double drift;      // (mu - 0.5*sigma^2)*dt
+    double diffusion;  // sigma*sqrt(dt)
+};
+
+/**
+ * Precomputes the GBM step coefficients
+ * 
+ * @param mu Interest rate (drift)
+ * @param sigma Volatility
+ * @param dt Time step size
+ * @return Drift and diffusion terms of one step
+ */
+GbmStep make_gbm_step(double mu, double sigma, double dt);
+
+/**
+ * Advances a block of paths through consecutive steps in log space
+ * Paths are the vectorized dimension: each step updates all lanes at once.
+ * The exp back to price space is deferred to whoever observes the prices.
+ * 
+ * @param step Precomputed step coefficients
+ * @param log_prices Current log price of each lane, updated in place
+ * @param Z Normals laid out [step][lane]; overwritten with the log price after each step
+ * @param lanes Number of paths in the block
+ * @param steps Number of steps to advance
+ */
+void advance_log_prices(const GbmStep& step, double* log_prices, double* Z, int lanes, int steps);
+
 /**
  * Calculates European Call option price using Monte Carlo method
  * Call Price = e^(-r*T) * (1/N) * Σ max(S_T - K, 0)
@@ -0,0 +1,273 @@
+#include "path_store.h"
+
+#include <algorithm>  // for std::min, std::max
+#include <climits>    // for INT_MAX
+#include <cstdlib>    // for std::aligned_alloc, std::free
+#include <cstring>    // for std::memcpy, std::memcmp
+#include <fstream>    // for std::ofstream
+#include <new>        // for std::bad_alloc
+#include <stdexcept>  // for std::runtime_error
+#include <utility>    // for std::swap
+#include <vector>     // for std::vector
+
+#include <fcntl.h>     // for open, posix_fallocate
+#include <sys/mman.h>  // for mmap, munmap, madvise
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close, ftruncate
+
+/**
+ * Implementation of the contiguous path store
+ */
+
+namespace {
+
+constexpr std::size_t CACHE_LINE = 64;
+constexpr std::size_t HUGE_PAGE = std::size_t(2) << 20;  // 2 MiB, the x86-64 and AArch64 huge page size
+constexpr std::size_t DATA_OFFSET = HUGE_PAGE;  // path file data starts on a huge-page boundary
+constexpr char MAGIC[8] = {'M', 'C', 'P', 'A', 'T', 'H', 'S', '\0'};
+constexpr std::uint32_t VERSION = 2;
+constexpr std::uint32_t OLDEST_VERSION = 1;  // float64 only, read as precision 0
+
+static_assert(sizeof(PathStore::FileHeader) == 64, "path file header must stay 64 bytes");
+
+/**
+ * Rounds a row length up to a whole number of cache lines
+ */
+std::size_t padded(int n, std::size_t element_bytes) {
+    std::size_t per_line = CACHE_LINE / element_bytes;
+    return (static_cast<std::size_t>(n) + per_line - 1) / per_line * per_line;
+}
+
+/**
+ * Allocates a cache-line aligned buffer (bytes is a multiple of the cache line)
+ */
+unsigned char* allocate(std::size_t bytes) {
+    if (bytes == 0) return nullptr;
+    void* ptr = std::aligned_alloc(CACHE_LINE, bytes);
+    if (!ptr) throw std::bad_alloc();
+    return static_cast<unsigned char*>(ptr);
+}
+
+/**
+ * Hints that a mapping may use transparent huge pages (no-op where unsupported)
+ */
+void advise_huge_pages(void* ptr, std::size_t bytes) {
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, bytes, MADV_HUGEPAGE);
+#else
+    (void)ptr;
+    (void)bytes;
+#endif
+}
+
+}  // namespace
+
+PathStore::~PathStore() {
+    release();
+}
+
+PathStore::PathStore(PathStore&& other) noexcept {
+    *this = std::move(other);
+}
+
+PathStore& PathStore::operator=(PathStore&& other) noexcept {
+    std::swap(data, other.data);
+    std::swap(num_paths, other.num_paths);
+    std::swap(num_steps, other.num_steps);
+    std::swap(row_stride, other.row_stride);
+    std::swap(capacity, other.capacity);
+    std::swap(layout, other.layout);
+    std::swap(precision, other.precision);
+    std::swap(file, other.file);
+    std::swap(mapping, other.mapping);
+    std::swap(mapped_bytes, other.mapped_bytes);
+    std::swap(read_only, other.read_only);
+    return *this;
+}
+
+void PathStore::release() {
+    if (mapping) {
+        munmap(mapping, mapped_bytes);  // dirty pages stay in the page cache and reach the file
+    } else {
+        std::free(data);
+    }
+    data = nullptr;
+    capacity = 0;
+    mapping = nullptr;
+    mapped_bytes = 0;
+}
+
+void PathStore::back_with_file(const std::string& path) {
+    if (path == file && !read_only) return;
+    release();
+    file = path;
+    read_only = false;
+}
+
+/**
+ * Recreates the backing file with room for the given number of data bytes and maps it shared
+ * The blocks are reserved up front, so a full disk is reported here instead
+ * of as a SIGBUS in the middle of a run
+ */
+void PathStore::map(std::size_t data_bytes) {
+    release();
+    std::size_t bytes = (DATA_OFFSET + data_bytes + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+
+    int fd = open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("cannot create path file '" + file + "'");
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0 || posix_fallocate(fd, 0, static_cast<off_t>(bytes)) != 0) {
+        close(fd);
+        throw std::runtime_error("cannot reserve " + std::to_string(bytes >> 20) + " MiB for path file '" + file + "'");
+    }
+    void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping keeps the file open
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error("cannot map path file '" + file + "'");
+    }
+    advise_huge_pages(ptr, bytes);
+
+    mapping = ptr;
+    mapped_bytes = bytes;
+    data = static_cast<unsigned char*>(ptr) + DATA_OFFSET;
+    capacity = bytes - DATA_OFFSET;
+}
+
+PathStore::FileHeader PathStore::file_header() const {
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.layout = layout == PathLayout::PathMajor ? 0 : 1;
+    header.num_paths = num_paths;
+    header.num_steps = num_steps;
+    header.row_stride = row_stride;
+    header.data_offset = DATA_OFFSET;
+    header.precision = static_cast<std::uint32_t>(precision);
+    return header;
+}
+
+/**
+ * Records the current shape at the start of the backing file
+ */
+void PathStore::write_header() {
+    if (!mapping || read_only) return;
+    FileHeader header = file_header();
+    std::memcpy(mapping, &header, sizeof(header));
+}
+
+/**
+ * Writes the header, zero padding up to the data offset, then the used rows in one piece
+ */
+void PathStore::write_file(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("cannot write path file '" + path + "'");
+    }
+    FileHeader header = file_header();
+    std::vector<char> padding(DATA_OFFSET - sizeof(header), 0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding.data(), padding.size());
+    int rows = layout == PathLayout::PathMajor ? num_paths : num_steps;
+    if (data) {
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::size_t>(rows) * row_stride * element_bytes());
+    }
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("cannot write path file '" + path + "'");
+    }
+}
+
+/**
+ * Maps the whole file read-only; the header is validated against the file size
+ * so that no row can point past the end of the mapping
+ */
+PathStore PathStore::open_file(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open path file '" + path + "'");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        throw std::runtime_error("'" + path + "' is not a path file");
+    }
+    std::size_t bytes = static_cast<std::size_t>(info.st_size);
+    void* ptr = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error("cannot map path file '" + path + "'");
+    }
+
+    PathStore store;  // owns the mapping from here on, so every throw below unmaps it
+    store.file = path;
+    store.read_only = true;
+    store.mapping = ptr;
+    store.mapped_bytes = bytes;
+
+    FileHeader header;
+    std::memcpy(&header, ptr, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("'" + path + "' is not a path file");
+    }
+    if (header.version < OLDEST_VERSION || header.version > VERSION) {
+        throw std::runtime_error("path file '" + path + "' has unsupported version " + std::to_string(header.version));
+    }
+    std::uint64_t element = header.precision == 1 ? sizeof(float) : sizeof(double);
+    std::uint64_t rows = header.layout == 0 ? header.num_paths : header.num_steps;
+    std::uint64_t cols = header.layout == 0 ? header.num_steps : header.num_paths;
+    bool valid = header.layout <= 1 && header.precision <= 1 &&
+                 header.num_paths <= INT_MAX && header.num_steps <= INT_MAX && header.row_stride >= cols &&
+                 header.data_offset >= sizeof(FileHeader) && header.data_offset % element == 0 &&
+                 header.data_offset <= bytes &&
+                 rows <= (bytes - header.data_offset) / element / std::max<std::uint64_t>(header.row_stride, 1);
+    if (!valid) {
+        throw std::runtime_error("'" + path + "' is not a valid path file");
+    }
+
+    // Repricing scans the rows front to back: read ahead aggressively and drop pages behind
+    madvise(ptr, bytes, MADV_SEQUENTIAL);
+    advise_huge_pages(ptr, bytes);
+
+    store.num_paths = static_cast<int>(header.num_paths);
+    store.num_steps = static_cast<int>(header.num_steps);
+    store.row_stride = header.row_stride;
+    store.layout = header.layout == 0 ? PathLayout::PathMajor : PathLayout::StepMajor;
+    store.precision = header.precision == 1 ? PathPrecision::Float32 : PathPrecision::Float64;
+    store.data = static_cast<unsigned char*>(ptr) + header.data_offset;
+    store.capacity = rows * header.row_stride * element;
+    return store;
+}
+
+/**
+ * Uses one padded, aligned buffer for all paths, reallocated (or remapped) only when it grows
+ */
+void PathStore::resize(int paths, int steps, PathLayout new_layout, PathPrecision new_precision) {
+    if (read_only) {
+        throw std::runtime_error("path file '" + file + "' is open read-only");
+    }
+    num_paths = paths;
+    num_steps = steps;
+    layout = new_layout;
+    precision = new_precision;
+
+    int rows = layout == PathLayout::PathMajor ? num_paths : num_steps;
+    int cols = layout == PathLayout::PathMajor ? num_steps : num_paths;
+    row_stride = padded(cols, element_bytes());
+    std::size_t required = static_cast<std::size_t>(rows) * row_stride * element_bytes();
+    if (required > capacity) {
+        if (file_backed()) {
+            map(required);
+        } else {
+            release();
+            data = allocate(required);
+            capacity = required;
+        }
+    }
+    write_header();
+}
+
+void PathStore::truncate(int paths) {
+    num_paths = std::min(paths, num_paths);
+    write_header();
+}
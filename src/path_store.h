@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>  // for std::copy
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint32_t, std::uint64_t
+#include <string>   // for std::string
+
+/**
+ * Contiguous storage for simulated asset price paths
+ *
+ * All paths live in one cache-line aligned buffer instead of a
+ * vector of separately allocated rows. The layout is selectable:
+ * - PathMajor: [path_number][time_step], one contiguous row per path
+ * - StepMajor: [time_step][path_number], the layout the simulator generates.
+ *   Paths are advanced in blocks, one time step at a time, so each block
+ *   writes its lanes as one short contiguous run in every step row, and
+ *   readers working across paths (averages, replay) scan the rows in order
+ *
+ * Rows are padded to a whole number of cache lines so that every row starts
+ * on a cache line. Threads fill disjoint ranges of paths whose sizes are
+ * multiples of a cache line, so two threads never share a cache line.
+ *
+ * Prices are stored as float64 or, to halve the memory traffic and the
+ * footprint, as float32. Paths are always simulated in double precision and
+ * only the stored observations are rounded, once each, with a relative error
+ * of at most 2^-24 (about 6e-8) for prices in float32's normal range.
+ * Readers add stored prices up in double (accumulate()), so an average of
+ * n stored prices is within 2^-24 + n * 2^-53 (relative) of the average of
+ * the unrounded prices: under 1.2e-7 for any n up to 2^29. On a price of
+ * 100 that is about 1e-5, far below Monte Carlo standard errors, and since
+ * payoffs such as max(A - K, 0) move at most one for one with the average,
+ * the same bound holds for every stored-path payoff. Compensated summation
+ * would only remove the n * 2^-53 term, which the float32 rounding dominates.
+ *
+ * The buffer is heap memory by default. A store backed by a file keeps the
+ * prices in a shared memory mapping of that file instead, so the page cache
+ * writes them back as memory fills up and path sets larger than RAM can be
+ * generated. The file is left behind as a persistent copy of the paths, and
+ * open_file() maps it again read-only (zero-copy) to reprice new payoffs
+ * without simulating.
+ *
+ * File layout, native byte order (little-endian on x86-64 and AArch64):
+ *   offset 0        header (64 bytes, see FileHeader)
+ *   offset 2 MiB    the rows, row_stride elements apart
+ * The data starts on a huge-page boundary and the file is grown in whole
+ * huge pages, so the kernel can back the mapping with 2 MiB pages where the
+ * file system supports it (MADV_HUGEPAGE), which keeps TLB misses down when
+ * a step-major scan strides through tens of GB.
+ */
+
+enum class PathLayout {
+    PathMajor,  // row = one path, column = time step
+    StepMajor   // row = one time step, column = path
+};
+
+enum class PathPrecision : std::uint32_t {
+    Float64 = 0,
+    Float32 = 1
+};
+
+class PathStore {
+    public:
+        PathStore() = default;
+        ~PathStore();
+
+        PathStore(const PathStore&) = delete;
+        PathStore& operator=(const PathStore&) = delete;
+        PathStore(PathStore&& other) noexcept;
+        PathStore& operator=(PathStore&& other) noexcept;
+
+        /**
+         * Sizes the store for num_paths x num_steps prices in the given layout
+         * The existing buffer is reused when it is large enough, so repeated
+         * runs of the same (or a smaller) shape do not allocate. Contents are
+         * left uninitialized: every cell is overwritten by the next simulation
+         *
+         * @param num_paths Number of simulated paths
+         * @param num_steps Number of time steps per path
+         * @param layout Initial memory layout
+         * @param precision Stored precision
+         */
+        void resize(int num_paths, int num_steps, PathLayout layout = PathLayout::PathMajor,
+                    PathPrecision precision = PathPrecision::Float64);
+
+        /**
+         * Keeps only the first paths paths, e.g. when a run stops before its budget
+         * The buffer and the row stride are unchanged
+         *
+         * @param paths Number of paths to keep (at most paths())
+         */
+        void truncate(int paths);
+
+        /**
+         * Keeps the prices in a memory-mapped file from the next resize() on
+         * The file is created (or overwritten) and sized by resize(); its
+         * header always describes the current shape. Heap contents are dropped.
+         * Throws std::runtime_error if the file cannot be created or mapped
+         *
+         * @param path File to back the store with
+         */
+        void back_with_file(const std::string& path);
+
+        /**
+         * Maps a path file written by a file-backed store, read-only and without copying
+         * Only the const accessors may be used on the result; resizing it throws.
+         * Throws std::runtime_error if the file cannot be mapped or is not a path file
+         *
+         * @param path Path file
+         * @return Store viewing the file's prices
+         */
+        static PathStore open_file(const std::string& path);
+
+        /**
+         * Writes the stored prices to a path file that open_file() can map
+         * File-backed stores already live in their file and need not be written
+         * Throws std::runtime_error if the file cannot be written
+         *
+         * @param path File to create
+         */
+        void write_file(const std::string& path) const;
+
+        /**
+         * Returns a pointer to the start of a row of a Float64 store
+         * In PathMajor layout a row is one path, in StepMajor layout one time step
+         *
+         * @param r Row index
+         * @return Pointer to the first element of the row
+         */
+        double* row(int r) { return reinterpret_cast<double*>(row_bytes(r)); }
+        const double* row(int r) const { return reinterpret_cast<const double*>(row_bytes(r)); }
+
+        /**
+         * Stores consecutive elements of a row, rounded to the stored precision
+         *
+         * @param r Row index
+         * @param first First column to write
+         * @param values Prices to store
+         * @param n Number of prices
+         */
+        void store(int r, int first, const double* values, int n) {
+            if (precision == PathPrecision::Float32) {
+                float* target = reinterpret_cast<float*>(row_bytes(r)) + first;
+                for (int i = 0; i < n; i++) {
+                    target[i] = static_cast<float>(values[i]);
+                }
+            } else {
+                std::copy(values, values + n, row(r) + first);
+            }
+        }
+
+        /**
+         * Adds consecutive elements of a row to double-precision sums
+         *
+         * @param r Row index
+         * @param first First column to read
+         * @param n Number of elements
+         * @param sums Running sums, sums[i] += element first + i
+         */
+        void accumulate(int r, int first, int n, double* sums) const {
+            if (precision == PathPrecision::Float32) {
+                const float* source = reinterpret_cast<const float*>(row_bytes(r)) + first;
+                for (int i = 0; i < n; i++) {
+                    sums[i] += source[i];
+                }
+            } else {
+                const double* source = row(r) + first;
+                for (int i = 0; i < n; i++) {
+                    sums[i] += source[i];
+                }
+            }
+        }
+
+        /**
+         * Layout-independent element access
+         *
+         * @param path Path index
+         * @param step Time step index
+         * @return Stored price
+         */
+        double at(int path, int step) const {
+            int r = layout == PathLayout::PathMajor ? path : step;
+            int c = layout == PathLayout::PathMajor ? step : path;
+            return precision == PathPrecision::Float32 ? reinterpret_cast<const float*>(row_bytes(r))[c] : row(r)[c];
+        }
+
+        /**
+         * Returns a price as the store would hold it
+         */
+        double rounded(double value) const {
+            return precision == PathPrecision::Float32 ? static_cast<float>(value) : value;
+        }
+
+        int paths() const { return num_paths; }
+        int steps() const { return num_steps; }
+        PathLayout current_layout() const { return layout; }
+        PathPrecision stored_precision() const { return precision; }
+        bool empty() const { return data == nullptr; }
+        bool file_backed() const { return !file.empty(); }
+
+        /**
+         * Header at the start of a path file
+         */
+        struct FileHeader {
+            char magic[8];              // "MCPATHS" followed by a NUL
+            std::uint32_t version;      // 2 (version 1 files have no precision and hold float64)
+            std::uint32_t layout;       // 0 = PathMajor, 1 = StepMajor
+            std::uint64_t num_paths;
+            std::uint64_t num_steps;
+            std::uint64_t row_stride;   // elements between consecutive rows
+            std::uint64_t data_offset;  // byte offset of the first row
+            std::uint32_t precision;    // 0 = float64, 1 = float32
+            std::uint32_t reserved[3];  // zero
+        };
+
+    private:
+        unsigned char* data = nullptr;
+        int num_paths = 0;
+        int num_steps = 0;
+        std::size_t row_stride = 0;  // elements between consecutive rows (padded)
+        std::size_t capacity = 0;    // bytes allocated in data
+        PathLayout layout = PathLayout::PathMajor;
+        PathPrecision precision = PathPrecision::Float64;
+        std::string file;            // backing file, empty for heap memory
+        void* mapping = nullptr;     // start of the file mapping (header included)
+        std::size_t mapped_bytes = 0;
+        bool read_only = false;      // mapped by open_file()
+
+        std::size_t element_bytes() const { return precision == PathPrecision::Float32 ? sizeof(float) : sizeof(double); }
+        unsigned char* row_bytes(int r) { return data + static_cast<std::size_t>(r) * row_stride * element_bytes(); }
+        const unsigned char* row_bytes(int r) const {
+            return data + static_cast<std::size_t>(r) * row_stride * element_bytes();
+        }
+
+        void release();
+        void map(std::size_t bytes);
+        FileHeader file_header() const;
+        void write_header();
+};
@@ -0,0 +1,210 @@
+#include "payoff.h"
+#include "simd.h"
+
+#include <algorithm>  // for std::max, std::min
+#include <cmath>      // for std::sqrt
+
+/**
+ * Implementation of the payoff set and its fused reduction
+ */
+
+namespace {
+
+constexpr int EVAL_CHUNK = 64;  // payoff values evaluated per pass
+
+/**
+ * Writes f(x) for every x in values to out
+ * With a mirror buffer, each output is the average of f over an antithetic pair
+ */
+template <typename PayoffFn>
+inline void evaluate(const double* values, const double* mirror, int n, double* out, PayoffFn f) {
+    if (mirror) {
+        for (int i = 0; i < n; i++) {
+            out[i] = 0.5 * (f(values[i]) + f(mirror[i]));
+        }
+    } else {
+        for (int i = 0; i < n; i++) {
+            out[i] = f(values[i]);
+        }
+    }
+}
+
+}  // namespace
+
+/**
+ * One branch per payoff, branch-free across paths
+ */
+SIMD_DISPATCH
+void evaluate_payoff(PayoffType type, double K, const double* values, const double* mirror, int n, double* out) {
+    switch (type) {
+        case PayoffType::Call:
+        case PayoffType::AsianCall:
+            evaluate(values, mirror, n, out, [K](double S) { return std::max(S - K, 0.0); });
+            break;
+        case PayoffType::Put:
+        case PayoffType::AsianPut:
+            evaluate(values, mirror, n, out, [K](double S) { return std::max(K - S, 0.0); });
+            break;
+        case PayoffType::DigitalCall:
+            evaluate(values, mirror, n, out, [K](double S) { return S > K ? 1.0 : 0.0; });
+            break;
+        case PayoffType::DigitalPut:
+            evaluate(values, mirror, n, out, [K](double S) { return S < K ? 1.0 : 0.0; });
+            break;
+        case PayoffType::Forward:
+            evaluate(values, mirror, n, out, [K](double S) { return S - K; });
+            break;
+    }
+}
+
+bool is_path_dependent(PayoffType type) {
+    return type == PayoffType::AsianCall || type == PayoffType::AsianPut;
+}
+
+std::string payoff_name(PayoffType type) {
+    switch (type) {
+        case PayoffType::Call: return "Call";
+        case PayoffType::Put: return "Put";
+        case PayoffType::DigitalCall: return "Digital Call";
+        case PayoffType::DigitalPut: return "Digital Put";
+        case PayoffType::Forward: return "Forward";
+        case PayoffType::AsianCall: return "Asian Call";
+        case PayoffType::AsianPut: return "Asian Put";
+    }
+    return "Unknown";
+}
+
+double payoff_value(const Payoff& payoff, double terminal, double average) {
+    double K = payoff.strike;
+    switch (payoff.type) {
+        case PayoffType::Call: return std::max(terminal - K, 0.0);
+        case PayoffType::Put: return std::max(K - terminal, 0.0);
+        case PayoffType::DigitalCall: return terminal > K ? 1.0 : 0.0;
+        case PayoffType::DigitalPut: return terminal < K ? 1.0 : 0.0;
+        case PayoffType::Forward: return terminal - K;
+        case PayoffType::AsianCall: return std::max(average - K, 0.0);
+        case PayoffType::AsianPut: return std::max(K - average, 0.0);
+    }
+    return 0.0;
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    long total = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta * other.count / total;
+    m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / total);
+    count = total;
+}
+
+PayoffReduction::PayoffReduction(const std::vector<Payoff>& payoffs, bool track_covariance) {
+    reset(payoffs, track_covariance);
+}
+
+void PayoffReduction::reset(const std::vector<Payoff>& payoffs, bool track_covariance) {
+    stats.assign(payoffs.size(), RunningStats{});
+    values.resize(payoffs.size() * EVAL_CHUNK);
+    if (track_covariance) {
+        comoments.assign(payoffs.size() * payoffs.size(), 0.0);
+    } else {
+        comoments.clear();
+    }
+}
+
+void PayoffReduction::add(const std::vector<Payoff>& payoffs, const double* terminal, const double* average, int n) {
+    for (int i = 0; i < n; i += EVAL_CHUNK) {
+        add_block(payoffs, terminal, average, i, std::min(EVAL_CHUNK, n - i), 0);
+    }
+}
+
+void PayoffReduction::add_antithetic(const std::vector<Payoff>& payoffs, const double* terminal, const double* average, int pairs) {
+    for (int i = 0; i < pairs; i += EVAL_CHUNK) {
+        add_block(payoffs, terminal, average, i, std::min(EVAL_CHUNK, pairs - i), pairs);
+    }
+}
+
+/**
+ * Evaluates every payoff on one chunk of samples, computes the chunk's
+ * statistics in two passes and merges them into the running totals
+ */
+void PayoffReduction::add_block(const std::vector<Payoff>& payoffs, const double* terminal, const double* average,
+                                int offset, int n, int mirror_offset) {
+    std::size_t P = payoffs.size();
+    RunningStats block[MAX_PAYOFFS];
+
+    for (std::size_t p = 0; p < P; p++) {
+        const double* source = (is_path_dependent(payoffs[p].type) ? average : terminal) + offset;
+        const double* mirror = mirror_offset > 0 ? source + mirror_offset : nullptr;
+        double* v = &values[p * EVAL_CHUNK];
+        evaluate_payoff(payoffs[p].type, payoffs[p].strike, source, mirror, n, v);
+
+        double sum = 0.0;
+        for (int i = 0; i < n; i++) sum += v[i];
+        double mean = sum / n;
+        double m2 = 0.0;
+        for (int i = 0; i < n; i++) m2 += (v[i] - mean) * (v[i] - mean);
+        block[p] = {n, mean, m2};
+    }
+
+    if (!comoments.empty()) {
+        // Chan update of every cross co-moment, using the means before this block is merged
+        long count_a = count();
+        double weight = static_cast<double>(count_a) * n / (count_a + n);
+        for (std::size_t p = 0; p < P; p++) {
+            const double* vp = &values[p * EVAL_CHUNK];
+            for (std::size_t q = p + 1; q < P; q++) {
+                const double* vq = &values[q * EVAL_CHUNK];
+                double block_comoment = 0.0;
+                for (int i = 0; i < n; i++) block_comoment += (vp[i] - block[p].mean) * (vq[i] - block[q].mean);
+                double delta_p = block[p].mean - stats[p].mean;
+                double delta_q = block[q].mean - stats[q].mean;
+                comoments[p * P + q] += block_comoment + delta_p * delta_q * weight;
+                comoments[q * P + p] = comoments[p * P + q];
+            }
+        }
+    }
+
+    for (std::size_t p = 0; p < P; p++) {
+        stats[p].merge(block[p]);
+    }
+}
+
+void PayoffReduction::merge(const PayoffReduction& other) {
+    if (stats.empty()) {
+        *this = other;
+        return;
+    }
+
+    std::size_t P = stats.size();
+    if (!comoments.empty() && other.count() > 0) {
+        long count_a = count();
+        long count_b = other.count();
+        double weight = static_cast<double>(count_a) * count_b / (count_a + count_b);
+        for (std::size_t p = 0; p < P; p++) {
+            for (std::size_t q = p + 1; q < P; q++) {
+                double delta_p = other.stats[p].mean - stats[p].mean;
+                double delta_q = other.stats[q].mean - stats[q].mean;
+                comoments[p * P + q] += other.comoments[p * P + q] + delta_p * delta_q * weight;
+                comoments[q * P + p] = comoments[p * P + q];
+            }
+        }
+    }
+
+    for (std::size_t p = 0; p < P; p++) {
+        stats[p].merge(other.stats[p]);
+    }
+}
+
+double PayoffReduction::covariance(int i, int j) const {
+    if (i == j) return variance(i);
+    long n = count();
+    return n > 1 ? comoments[i * stats.size() + j] / (n - 1) : 0.0;
+}
+
+double PayoffReduction::std_error(int i) const {
+    return stats[i].count > 0 ? std::sqrt(stats[i].variance() / stats[i].count) : 0.0;
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <string>  // for std::string
+#include <vector>  // for std::vector
+
+/**
+ * Option payoffs and their fused Monte Carlo reduction
+ *
+ * A simulation prices a whole set of payoffs at once: every block of
+ * simulated paths is reduced into per-payoff means and variances while the
+ * terminal prices are still in registers/L1, instead of one full pass over
+ * final_prices per payoff afterwards.
+ */
+
+enum class PayoffType {
+    Call,         // max(S_T - K, 0)
+    Put,          // max(K - S_T, 0)
+    DigitalCall,  // 1 if S_T > K else 0
+    DigitalPut,   // 1 if S_T < K else 0
+    Forward,      // S_T - K
+    AsianCall,    // max(A - K, 0), A = arithmetic average price over all steps
+    AsianPut      // max(K - A, 0)
+};
+
+struct Payoff {
+    PayoffType type;
+    double strike;
+};
+
+/**
+ * Returns true if the payoff depends on prices before expiration
+ *
+ * @param type Payoff type
+ * @return Whether full path stepping is required
+ */
+bool is_path_dependent(PayoffType type);
+
+/**
+ * Human-readable payoff name used in the results table, e.g. "Asian Call"
+ *
+ * @param type Payoff type
+ * @return Display name
+ */
+std::string payoff_name(PayoffType type);
+
+/**
+ * Undiscounted payoff of a single path
+ *
+ * @param payoff Payoff description
+ * @param terminal Terminal asset price S_T
+ * @param average Arithmetic average price along the path (ignored by path-independent payoffs)
+ * @return Payoff at expiration
+ */
+double payoff_value(const Payoff& payoff, double terminal, double average);
+
+/**
+ * Undiscounted payoff of a block of paths (vectorized across paths)
+ *
+ * @param type Payoff type
+ * @param K Strike price
+ * @param values Terminal or average prices, whichever the payoff depends on
+ * @param mirror Prices of the antithetic partners (may be null); each output is then the pair average
+ * @param n Number of paths
+ * @param out Output payoffs
+ */
+void evaluate_payoff(PayoffType type, double K, const double* values, const double* mirror, int n, double* out);
+
+/**
+ * Running mean and variance of one payoff
+ *
+ * Stores (count, mean, M2) instead of raw sums of squares, so the variance
+ * does not suffer from cancellation when the mean is large relative to the
+ * spread. Partial statistics from disjoint path sets are combined with
+ * Chan's parallel form of Welford's update.
+ */
+struct RunningStats {
+    long count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;  // sum of squared deviations from the mean
+
+    /**
+     * Merges statistics of a disjoint sample into this one
+     *
+     * @param other Statistics to merge
+     */
+    void merge(const RunningStats& other);
+
+    /**
+     * Unbiased sample variance
+     */
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+};
+
+/**
+ * Running statistics of every payoff in a set
+ *
+ * Each block of paths is evaluated in a vectorized two-pass loop (block
+ * mean, then squared deviations) and folded into the running statistics
+ * with one Welford/Chan merge per payoff. The result is deterministic for
+ * a fixed order of blocks and merges.
+ *
+ * Optionally the co-moments between every pair of payoffs are tracked as
+ * well (merged the same way), which is what control variates need.
+ */
+class PayoffReduction {
+    public:
+        static constexpr int MAX_PAYOFFS = 16;  // payoffs per set
+
+        PayoffReduction() = default;
+
+        /**
+         * @param payoffs Payoff set to reduce (at most MAX_PAYOFFS)
+         * @param track_covariance Also track the cross co-moments between payoffs
+         */
+        explicit PayoffReduction(const std::vector<Payoff>& payoffs, bool track_covariance = false);
+
+        /**
+         * Clears all statistics for a new run, keeping the allocated buffers
+         * when the payoff set has the same size
+         *
+         * @param payoffs Payoff set to reduce (at most MAX_PAYOFFS)
+         * @param track_covariance Also track the cross co-moments between payoffs
+         */
+        void reset(const std::vector<Payoff>& payoffs, bool track_covariance = false);
+
+        /**
+         * Adds a block of simulated paths to every payoff's statistics
+         *
+         * @param payoffs The payoff set this reduction was created for
+         * @param terminal Terminal prices of the block
+         * @param average Average prices of the block (may be null if no payoff is path-dependent)
+         * @param n Number of paths in the block
+         */
+        void add(const std::vector<Payoff>& payoffs, const double* terminal, const double* average, int n);
+
+        /**
+         * Adds a block of antithetic path pairs; each pair counts as one sample
+         * (the average of its two payoffs), so the variance and standard error
+         * reflect the negative correlation within each pair
+         *
+         * @param payoffs The payoff set this reduction was created for
+         * @param terminal Terminal prices: pairs primary paths, then their pairs mirrored paths
+         * @param average Average prices in the same layout (may be null if no payoff is path-dependent)
+         * @param pairs Number of antithetic pairs in the block
+         */
+        void add_antithetic(const std::vector<Payoff>& payoffs, const double* terminal, const double* average, int pairs);
+
+        /**
+         * Merges another partial reduction into this one
+         *
+         * @param other Reduction over a disjoint set of paths
+         */
+        void merge(const PayoffReduction& other);
+
+        /**
+         * Number of samples added (paths, or pairs in antithetic mode)
+         */
+        long count() const { return stats.empty() ? 0 : stats[0].count; }
+
+        /**
+         * Mean undiscounted payoff
+         *
+         * @param i Index of the payoff in the set
+         * @return Average payoff over all paths added so far
+         */
+        double mean(int i) const { return stats[i].mean; }
+
+        /**
+         * Sample variance of the undiscounted payoff
+         *
+         * @param i Index of the payoff in the set
+         * @return Unbiased variance estimate
+         */
+        double variance(int i) const { return stats[i].variance(); }
+
+        /**
+         * Sample covariance between two undiscounted payoffs
+         * Requires track_covariance
+         *
+         * @param i Index of the first payoff
+         * @param j Index of the second payoff
+         * @return Unbiased covariance estimate
+         */
+        double covariance(int i, int j) const;
+
+        /**
+         * Standard error of the mean undiscounted payoff, sqrt(variance / N)
+         *
+         * @param i Index of the payoff in the set
+         * @return Standard error of mean(i)
+         */
+        double std_error(int i) const;
+
+    private:
+        std::vector<RunningStats> stats;  // per payoff
+        std::vector<double> comoments;    // [i * P + j] sums of (x_i - mean_i)(x_j - mean_j), empty if not tracked
+        std::vector<double> values;       // [payoff][EVAL_CHUNK] scratch for one evaluated block
+
+        void add_block(const std::vector<Payoff>& payoffs, const double* terminal, const double* average,
+                       int offset, int n, int mirror_offset);
+};
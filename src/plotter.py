@@ -1,7 +1,43 @@
+import os
+import sys
+
+import numpy as np
 import pandas as pd
 import plotly.graph_objects as go
 
-df = pd.read_csv('dist/Data.csv')
+# Binary columnar layout written by ColumnWriter::write_binary (see column_writer.h)
+HEADER = np.dtype([("magic", "S8"), ("version", "<u4"), ("num_columns", "<u4"), ("num_rows", "<u8")])
+DESCRIPTOR = np.dtype([("name", "S48"), ("type", "<u4"), ("reserved", "<u4"), ("offset", "<u8")])
+COLUMN_TYPES = {0: np.dtype("<f8"), 1: np.dtype("<f4")}
+
+
+def read_columns(path):
+    """Memory-maps a binary column file; the columns are views into the mapping, nothing is parsed"""
+    raw = np.memmap(path, dtype=np.uint8, mode="r")
+    header = raw[:HEADER.itemsize].view(HEADER)[0]
+    if header["magic"] != b"MCCOLUMN" or header["version"] != 1:
+        raise ValueError(f"{path} is not a version 1 column file")
+
+    num_rows = int(header["num_rows"])
+    end = HEADER.itemsize + int(header["num_columns"]) * DESCRIPTOR.itemsize
+    columns = {}
+    for descriptor in raw[HEADER.itemsize:end].view(DESCRIPTOR):
+        dtype = COLUMN_TYPES[int(descriptor["type"])]
+        start = int(descriptor["offset"])
+        name = descriptor["name"].rstrip(b"\0").decode()
+        columns[name] = raw[start:start + num_rows * dtype.itemsize].view(dtype)
+    return pd.DataFrame(columns, copy=False)
+
+
+# The simulator writes dist/Data.bin, or dist/Data.csv when run with --csv, and
+# neither when averaged paths were not requested (terminal prices only)
+if os.path.exists("dist/Data.bin"):
+    df = read_columns("dist/Data.bin")
+elif os.path.exists("dist/Data.csv"):
+    df = pd.read_csv("dist/Data.csv")
+else:
+    print("No visualization data in dist/ (averaged paths were not requested), nothing to plot")
+    sys.exit(0)
 
 fig = go.Figure()
 
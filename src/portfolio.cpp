@@ -0,0 +1,109 @@
+#include "portfolio.h"
+
+#include <cctype>     // for std::isalpha
+#include <fstream>    // for std::ifstream
+#include <sstream>    // for std::istringstream
+#include <stdexcept>  // for std::runtime_error
+
+/**
+ * Implementation of the portfolio reader
+ */
+
+namespace {
+
+/**
+ * Strips trailing blanks; std::sto* already skip leading ones
+ */
+std::string trim_trailing(const std::string& field) {
+    std::size_t end = field.find_last_not_of(" \t");
+    return end == std::string::npos ? std::string() : field.substr(0, end + 1);
+}
+
+/**
+ * Whole-field conversions: trailing text such as "100abc" or "1.5x" throws
+ * std::invalid_argument instead of being ignored by std::sto*
+ */
+double parse_double(const std::string& field) {
+    std::string text = trim_trailing(field);
+    std::size_t pos = 0;
+    double value = std::stod(text, &pos);
+    if (pos != text.size()) throw std::invalid_argument(field);
+    return value;
+}
+
+int parse_int(const std::string& field) {
+    std::string text = trim_trailing(field);
+    std::size_t pos = 0;
+    int value = std::stoi(text, &pos);
+    if (pos != text.size()) throw std::invalid_argument(field);
+    return value;
+}
+
+/**
+ * std::stoull negates a leading '-' instead of rejecting it, so "-5" would become 2^64 - 5
+ */
+std::uint64_t parse_seed(const std::string& field) {
+    std::string text = trim_trailing(field);
+    std::size_t first = text.find_first_not_of(" \t");
+    if (first != std::string::npos && text[first] == '-') throw std::invalid_argument(field);
+    std::size_t pos = 0;
+    std::uint64_t value = std::stoull(text, &pos);
+    if (pos != text.size()) throw std::invalid_argument(field);
+    return value;
+}
+
+/**
+ * Parses one CSV line into a contract, returning false if a required field is missing or malformed
+ */
+bool parse_contract(const std::string& line, Contract& contract) {
+    std::istringstream fields(line);
+    std::vector<std::string> columns;
+    std::string column;
+    while (std::getline(fields, column, ',')) {
+        columns.push_back(column);
+    }
+    if (columns.size() < 7 || columns.size() > 9) return false;
+
+    try {
+        contract.asset_price = parse_double(columns[0]);
+        contract.strike_price = parse_double(columns[1]);
+        contract.time_to_expiration = parse_double(columns[2]);
+        contract.volatility = parse_double(columns[3]);
+        contract.interest_rate = parse_double(columns[4]);
+        contract.num_paths = parse_int(columns[5]);
+        contract.num_steps = parse_int(columns[6]);
+        contract.price_asian = columns.size() > 7 && parse_int(columns[7]) != 0;
+        contract.seed = columns.size() > 8 ? parse_seed(columns[8]) : 0;
+    } catch (const std::logic_error&) {  // std::invalid_argument, std::out_of_range
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+std::vector<Contract> read_portfolio(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        throw std::runtime_error("cannot open portfolio file '" + filename + "'");
+    }
+
+    std::vector<Contract> contracts;
+    std::string line;
+    for (int line_number = 1; std::getline(file, line); line_number++) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#' || std::isalpha(static_cast<unsigned char>(line[0]))) continue;
+
+        Contract contract;
+        std::string location = filename + ":" + std::to_string(line_number);
+        if (!parse_contract(line, contract)) {
+            throw std::runtime_error(location + ": expected 7 to 9 numeric columns");
+        }
+        if (contract.asset_price <= 0.0 || contract.strike_price <= 0.0 || contract.time_to_expiration <= 0.0 ||
+            contract.volatility <= 0.0 || contract.num_paths <= 0 || contract.num_steps <= 0) {
+            throw std::runtime_error(location + ": prices, expiry, volatility, paths and steps must be positive");
+        }
+        contracts.push_back(contract);
+    }
+    return contracts;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>  // for std::uint64_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+/**
+ * Portfolio files for non-interactive batch pricing
+ *
+ * A portfolio is a CSV file with one contract per line:
+ *   asset_price,strike_price,time_to_expiration,volatility,interest_rate,num_paths,num_steps,asian,seed
+ * A header line (any line starting with a letter), blank lines and lines
+ * starting with '#' are skipped. The trailing asian (0/1) and seed columns
+ * are optional and default to 0; seed 0 picks a random seed, as in the
+ * interactive mode.
+ */
+
+struct Contract {
+    double asset_price;
+    double strike_price;
+    double time_to_expiration;
+    double volatility;
+    double interest_rate;
+    int num_paths;
+    int num_steps;
+    bool price_asian = false;  // also price arithmetic-average Asian options
+    std::uint64_t seed = 0;
+};
+
+/**
+ * Reads every contract of a portfolio file
+ * Throws std::runtime_error naming the file and line on unreadable files,
+ * malformed lines and invalid parameters
+ *
+ * @param filename Path of the portfolio CSV
+ * @return Contracts in file order
+ */
+std::vector<Contract> read_portfolio(const std::string& filename);
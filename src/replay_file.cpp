@@ -0,0 +1,126 @@
+#include "replay_file.h"
+
+#include <cstring>     // for std::memcpy, std::memcmp
+#include <filesystem>  // for std::filesystem::path
+#include <fstream>     // for std::ifstream, std::ofstream
+#include <stdexcept>   // for std::runtime_error
+
+/**
+ * Implementation of the replay file format
+ */
+
+namespace {
+
+constexpr char MAGIC[8] = {'M', 'C', 'R', 'E', 'P', 'L', 'A', 'Y'};
+constexpr std::uint32_t VERSION = 1;
+constexpr std::uint32_t ANTITHETIC = 1;
+constexpr std::size_t ALIGNMENT = 64;
+
+static_assert(sizeof(ReplayHeader) == 128, "replay header must stay 128 bytes");
+
+std::uint64_t align_up(std::uint64_t offset) {
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+}  // namespace
+
+/**
+ * Stores the path file relative to the replay file when it can, so the
+ * two can be moved together
+ */
+void write_replay(const std::string& filename, const ReplayParameters& parameters,
+                  const std::vector<double>& terminal_prices, const std::string& path_file) {
+    std::string stored_path;
+    if (!path_file.empty()) {
+        std::filesystem::path directory = std::filesystem::path(filename).parent_path();
+        std::error_code error;
+        std::filesystem::path relative = std::filesystem::relative(path_file, directory.empty() ? "." : directory, error);
+        stored_path = error || relative.empty() ? std::filesystem::absolute(path_file).string() : relative.string();
+    }
+
+    ReplayHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.flags = parameters.antithetic ? ANTITHETIC : 0;
+    header.asset_price = parameters.asset_price;
+    header.strike_price = parameters.strike_price;
+    header.time_to_expiration = parameters.time_to_expiration;
+    header.volatility = parameters.volatility;
+    header.interest_rate = parameters.interest_rate;
+    header.seed = parameters.seed;
+    header.num_steps = parameters.num_steps;
+    header.sampling = parameters.sampling;
+    header.num_paths = terminal_prices.size();
+    header.path_file_length = stored_path.size();
+    header.prices_offset = align_up(sizeof(header) + stored_path.size());
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("cannot write replay file '" + filename + "'");
+    }
+    const char padding[ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(stored_path.data(), stored_path.size());
+    file.write(padding, header.prices_offset - sizeof(header) - stored_path.size());
+    file.write(reinterpret_cast<const char*>(terminal_prices.data()), terminal_prices.size() * sizeof(double));
+    file.flush();
+    if (!file) {
+        throw std::runtime_error("cannot write replay file '" + filename + "'");
+    }
+}
+
+ReplayRun read_replay(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("cannot open replay file '" + filename + "'");
+    }
+
+    ReplayHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("'" + filename + "' is not a replay file");
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error("replay file '" + filename + "' has unsupported version " +
+                                 std::to_string(header.version));
+    }
+    if (header.num_paths == 0 || header.num_paths > INT32_MAX || header.num_steps == 0 ||
+        header.num_steps > INT32_MAX || header.sampling < 1 || header.sampling > 3) {
+        throw std::runtime_error("replay file '" + filename + "' has an invalid header");
+    }
+
+    // Offsets and lengths are bounded by the file itself before anything is allocated
+    // from them; the subtractions cannot wrap since the header was read in full
+    file.seekg(0, std::ios::end);
+    std::uint64_t file_size = static_cast<std::uint64_t>(file.tellg());
+    if (header.path_file_length > file_size - sizeof(header) ||
+        header.prices_offset < sizeof(header) + header.path_file_length || header.prices_offset > file_size) {
+        throw std::runtime_error("replay file '" + filename + "' has an invalid header");
+    }
+    if (header.num_paths > (file_size - header.prices_offset) / sizeof(double)) {
+        throw std::runtime_error("replay file '" + filename + "' is truncated");
+    }
+
+    ReplayRun run;
+    run.parameters = {header.asset_price, header.strike_price, header.time_to_expiration, header.volatility,
+                      header.interest_rate, header.seed, static_cast<int>(header.num_steps),
+                      static_cast<int>(header.sampling), (header.flags & ANTITHETIC) != 0};
+
+    std::string stored_path(header.path_file_length, '\0');
+    file.seekg(sizeof(header));
+    if (!file.read(stored_path.data(), stored_path.size())) {
+        throw std::runtime_error("replay file '" + filename + "' is truncated");
+    }
+    if (!stored_path.empty()) {
+        std::filesystem::path path(stored_path);
+        run.path_file = path.is_absolute() ? path.string()
+                                           : (std::filesystem::path(filename).parent_path() / path).string();
+    }
+
+    run.terminal_prices.resize(header.num_paths);
+    file.seekg(header.prices_offset);
+    if (!file.read(reinterpret_cast<char*>(run.terminal_prices.data()), header.num_paths * sizeof(double))) {
+        throw std::runtime_error("replay file '" + filename + "' is truncated");
+    }
+    return run;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>  // for std::uint32_t, std::uint64_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+/**
+ * Saved scenario sets for repricing without simulating
+ *
+ * A replay file keeps the terminal price of every simulated path together
+ * with the parameters that generated them, and optionally refers to a path
+ * file (see path_store.h) holding every full path. Replaying it runs only
+ * the payoff stage: vanilla payoffs at any strike need the terminal prices
+ * alone, path-dependent payoffs need the path file.
+ *
+ * Layout, native byte order (little-endian on x86-64 and AArch64):
+ *   offset 0    header (128 bytes, see ReplayHeader)
+ *   offset 128  name of the path file (path_file_length bytes, no NUL),
+ *               relative to the directory of the replay file unless absolute
+ *   then the terminal prices, num_paths doubles starting on a 64-byte boundary
+ */
+
+/**
+ * Parameters of the run that generated a scenario set
+ */
+struct ReplayParameters {
+    double asset_price;
+    double strike_price;
+    double time_to_expiration;
+    double volatility;
+    double interest_rate;
+    std::uint64_t seed;
+    int num_steps;     // simulated steps per path (1 with exact terminal sampling)
+    int sampling;      // 1 = pseudo-random, 2 = Sobol, 3 = scrambled Sobol
+    bool antithetic;   // paths come in mirrored pairs, laid out as by the simulator's blocks
+};
+
+/**
+ * Header at the start of a replay file
+ */
+struct ReplayHeader {
+    char magic[8];                   // "MCREPLAY"
+    std::uint32_t version;           // 1
+    std::uint32_t flags;             // bit 0: antithetic
+    double asset_price;
+    double strike_price;
+    double time_to_expiration;
+    double volatility;
+    double interest_rate;
+    std::uint64_t seed;
+    std::uint32_t num_steps;
+    std::uint32_t sampling;
+    std::uint64_t num_paths;
+    std::uint64_t prices_offset;     // byte offset of the terminal prices
+    std::uint64_t path_file_length;  // 0 when only terminal prices were saved
+    std::uint64_t reserved[4];       // zero
+};
+
+/**
+ * Scenario set loaded from a replay file
+ */
+struct ReplayRun {
+    ReplayParameters parameters;
+    std::vector<double> terminal_prices;
+    std::string path_file;  // resolved against the replay file's directory, empty if none
+};
+
+/**
+ * Writes a scenario set
+ * Throws std::runtime_error if the file cannot be written
+ *
+ * @param filename Replay file to create
+ * @param parameters Parameters of the run
+ * @param terminal_prices Terminal price of every simulated path
+ * @param path_file Path file with every full path, or empty
+ */
+void write_replay(const std::string& filename, const ReplayParameters& parameters,
+                  const std::vector<double>& terminal_prices, const std::string& path_file);
+
+/**
+ * Reads a scenario set
+ * Throws std::runtime_error on unreadable, truncated, corrupt or foreign files and on unsupported versions
+ *
+ * @param filename Replay file
+ * @return Parameters, terminal prices and path file of the saved run
+ */
+ReplayRun read_replay(const std::string& filename);
@@ -0,0 +1,169 @@
+#include "rng.h"
+#include "simd.h"
+
+#include <algorithm>  // for std::min
+#include <cmath>      // for std::sqrt, std::log, std::fabs
+
+/**
+ * Implementation of the Philox counter-based generator and the block
+ * normal transform
+ */
+
+namespace {
+
+constexpr std::uint32_t PHILOX_M0 = 0xD2511F53;
+constexpr std::uint32_t PHILOX_M1 = 0xCD9E8D57;
+constexpr std::uint32_t PHILOX_W0 = 0x9E3779B9;  // golden ratio
+constexpr std::uint32_t PHILOX_W1 = 0xBB67AE85;  // sqrt(3) - 1
+constexpr int PHILOX_ROUNDS = 10;
+constexpr int UNIFORM_CHUNK = 256;  // uniforms generated per pass (2 KB, stays in L1)
+
+/**
+ * One Philox round: two 32x32->64 bit multiplies mixed with the key
+ */
+inline PhiloxCounter philox_round(const PhiloxCounter& c, const PhiloxKey& k) {
+    std::uint64_t p0 = static_cast<std::uint64_t>(PHILOX_M0) * c[0];
+    std::uint64_t p1 = static_cast<std::uint64_t>(PHILOX_M1) * c[2];
+    return {
+        static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k[0],
+        static_cast<std::uint32_t>(p1),
+        static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k[1],
+        static_cast<std::uint32_t>(p0)
+    };
+}
+
+inline PhiloxCounter philox_block(PhiloxCounter counter, PhiloxKey key) {
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        if (round > 0) {
+            key[0] += PHILOX_W0;
+            key[1] += PHILOX_W1;
+        }
+        counter = philox_round(counter, key);
+    }
+    return counter;
+}
+
+/**
+ * Fills out[0 .. 2*num_pairs) with the uniforms of consecutive step pairs of one path
+ * Counter layout: words 0-1 = 64-bit step pair index (step / 2),
+ * words 2-3 = 64-bit path index
+ */
+SIMD_DISPATCH
+void philox_uniform_pairs(PhiloxKey key, std::uint64_t path, std::uint64_t first_pair, int num_pairs, double* out) {
+    std::uint32_t path_lo = static_cast<std::uint32_t>(path);
+    std::uint32_t path_hi = static_cast<std::uint32_t>(path >> 32);
+    for (int i = 0; i < num_pairs; i++) {
+        std::uint64_t pair = first_pair + i;
+        PhiloxCounter bits = philox_block(
+            {static_cast<std::uint32_t>(pair), static_cast<std::uint32_t>(pair >> 32), path_lo, path_hi}, key);
+        out[2 * i] = to_uniform((static_cast<std::uint64_t>(bits[0]) << 32) | bits[1]);
+        out[2 * i + 1] = to_uniform((static_cast<std::uint64_t>(bits[2]) << 32) | bits[3]);
+    }
+}
+
+/**
+ * AS241 central region, |p - 0.5| <= 0.425
+ */
+inline double inverse_normal_central(double q) {
+    double r = 0.180625 - q * q;
+    double num = (((((((2509.0809287301226727 * r + 33430.575583588128105) * r + 67265.770927008700853) * r
+                   + 45921.953931549871457) * r + 13731.693765509461125) * r + 1971.5909503065514427) * r
+                   + 133.14166789178437745) * r + 3.387132872796366608);
+    double den = (((((((5226.495278852545925 * r + 28729.085735721942674) * r + 39307.89580009271061) * r
+                   + 21213.794301586595867) * r + 5394.1960214247511077) * r + 687.1870074920579083) * r
+                   + 42.313330701600911252) * r + 1.0);
+    return q * num / den;
+}
+
+}  // namespace
+
+PhiloxCounter philox4x32(PhiloxCounter counter, PhiloxKey key) {
+    return philox_block(counter, key);
+}
+
+double inverse_normal_cdf(double p) {
+    double q = p - 0.5;
+    if (std::fabs(q) <= 0.425) {
+        return inverse_normal_central(q);
+    }
+
+    // Tails: rational approximations in r = sqrt(-log(min(p, 1 - p)))
+    double r = std::sqrt(-std::log(q < 0.0 ? p : 1.0 - p));
+    double x;
+    if (r <= 5.0) {
+        r -= 1.6;
+        x = (((((((7.7454501427834140764e-4 * r + 0.0227238449892691845833) * r + 0.24178072517745061177) * r
+              + 1.27045825245236838258) * r + 3.64784832476320460504) * r + 5.7694972214606914055) * r
+              + 4.6303378461565452959) * r + 1.42343711074968357734)
+          / (((((((1.05075007164441684324e-9 * r + 5.475938084995344946e-4) * r + 0.0151986665636164571966) * r
+              + 0.14810397642748007459) * r + 0.68976733498510000455) * r + 1.6763848301838038494) * r
+              + 2.05319162663775882187) * r + 1.0);
+    } else {
+        r -= 5.0;
+        x = (((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r + 0.0012426609473880784386) * r
+              + 0.026532189526576123093) * r + 0.29656057182850489123) * r + 1.7848265399172913358) * r
+              + 5.4637849111641143699) * r + 6.6579046435011037772)
+          / (((((((2.04426310338993978564e-15 * r + 1.4215117583164458887e-7) * r + 1.8463183175100546818e-5) * r
+              + 7.868691311456132591e-4) * r + 0.0148753612908506148525) * r + 0.13692988092273580531) * r
+              + 0.59983220655588793769) * r + 1.0);
+    }
+    return q < 0.0 ? -x : x;
+}
+
+SIMD_DISPATCH
+void inverse_normal_cdf(const double* u, int n, double* out) {
+    // Pass 1: central rational for every value, no branches
+    for (int i = 0; i < n; i++) {
+        out[i] = inverse_normal_central(u[i] - 0.5);
+    }
+
+    // Pass 2: patch the ~15% of values that fall in the tails
+    for (int i = 0; i < n; i++) {
+        if (std::fabs(u[i] - 0.5) > 0.425) {
+            out[i] = inverse_normal_cdf(u[i]);
+        }
+    }
+}
+
+void PathRng::set_seed(std::uint64_t new_seed) {
+    seed_value = new_seed;
+    key = {static_cast<std::uint32_t>(new_seed), static_cast<std::uint32_t>(new_seed >> 32)};
+}
+
+/**
+ * Generates the path's uniforms chunk by chunk (a chunk always starts on a
+ * step pair boundary) and maps each chunk to normals in one block call
+ */
+void PathRng::normals(std::uint64_t path, std::uint64_t first_step, int count, double* out) const {
+    double u[UNIFORM_CHUNK];
+    std::uint64_t step = first_step;
+    int done = 0;
+
+    while (done < count) {
+        int offset = static_cast<int>(step & 1);  // odd first step skips the pair's first uniform
+        int n = std::min(count - done, UNIFORM_CHUNK - offset);
+        int pairs = (offset + n + 1) / 2;
+
+        philox_uniform_pairs(key, path, step >> 1, pairs, u);
+        inverse_normal_cdf(u + offset, n, out + done);
+
+        done += n;
+        step += n;
+    }
+}
+
+/**
+ * Generates each path's segment contiguously, then scatters it into its tile column
+ */
+void PathRng::normals_tile(std::uint64_t first_path, int num_paths, std::uint64_t first_step, int num_steps, double* out) const {
+    double z[UNIFORM_CHUNK];
+    for (int p = 0; p < num_paths; p++) {
+        for (int k0 = 0; k0 < num_steps; k0 += UNIFORM_CHUNK) {
+            int n = std::min(UNIFORM_CHUNK, num_steps - k0);
+            normals(first_path + p, first_step + k0, n, z);
+            for (int k = 0; k < n; k++) {
+                out[static_cast<long>(k0 + k) * num_paths + p] = z[k];
+            }
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>    // for std::array
+#include <cstdint>  // for std::uint32_t, std::uint64_t
+#include <cstring>  // for std::memcpy
+
+/**
+ * Counter-based random number generation for Monte Carlo paths
+ *
+ * Uses the Philox4x32-10 generator (Salmon et al., "Parallel Random
+ * Numbers: As Easy as 1, 2, 3"). Every random value is a pure function
+ * of (seed, path index, time step), so:
+ * - there is no generator state to set up or share between threads
+ * - a path's random numbers do not depend on which thread simulates it
+ *   or in which order, making single- and multi-threaded runs identical
+ * - skipping ahead to any path or step is free
+ */
+
+using PhiloxCounter = std::array<std::uint32_t, 4>;
+using PhiloxKey = std::array<std::uint32_t, 2>;
+
+/**
+ * Philox4x32-10 block function: encrypts a 128-bit counter under a 64-bit key
+ *
+ * @param counter Counter block
+ * @param key Key derived from the seed
+ * @return Four independent uniformly distributed 32-bit words
+ */
+PhiloxCounter philox4x32(PhiloxCounter counter, PhiloxKey key);
+
+/**
+ * Converts 64 random bits to a uniform double in the open interval (0, 1)
+ * Builds the double directly from its bit pattern (no integer-to-float
+ * conversion) so the operation vectorizes
+ *
+ * @param bits Random bits (the top 52 are used)
+ * @return Uniform variate strictly between 0 and 1
+ */
+inline double to_uniform(std::uint64_t bits) {
+    std::uint64_t mantissa = (bits >> 12) | 0x3FF0000000000000ULL;  // double in [1, 2)
+    double one_to_two;
+    std::memcpy(&one_to_two, &mantissa, sizeof(double));
+    return one_to_two - (1.0 - 1.1102230246251565e-16);  // shift by 1 - 2^-53 to center the grid in (0, 1)
+}
+
+/**
+ * Inverse of the standard normal cumulative distribution function
+ * Wichura's algorithm AS241 (PPND16), accurate to about 1e-16 relative
+ *
+ * @param p Probability in the open interval (0, 1)
+ * @return x such that P(Z <= x) = p
+ */
+double inverse_normal_cdf(double p);
+
+/**
+ * Block inverse normal CDF for a buffer of uniforms
+ * The central region (85% of samples) is evaluated branch-free across the
+ * whole buffer with the widest SIMD unit available at runtime; the tails
+ * are patched afterwards
+ *
+ * @param u Input uniforms in (0, 1)
+ * @param n Number of values
+ * @param out Output normals (must not alias u)
+ */
+void inverse_normal_cdf(const double* u, int n, double* out);
+
+/**
+ * Reproducible per-path normal streams keyed by (seed, path, step)
+ *
+ * Each Philox block yields two uniforms, covering an even step and the
+ * following odd step of one path. Uniforms are generated for a whole
+ * segment of a path at once and mapped to normals by the block inverse CDF.
+ */
+class PathRng {
+    public:
+        explicit PathRng(std::uint64_t seed = 0) { set_seed(seed); }
+
+        void set_seed(std::uint64_t new_seed);
+        std::uint64_t seed() const { return seed_value; }
+
+        /**
+         * Fills a buffer with the standard normal variates of one path
+         *
+         * @param path Path index
+         * @param first_step First time step to generate
+         * @param count Number of consecutive time steps
+         * @param out Output buffer of at least count doubles
+         */
+        void normals(std::uint64_t path, std::uint64_t first_step, int count, double* out) const;
+
+        /**
+         * Fills a [step][path] tile of normals for a block of consecutive paths
+         * Values are identical to those returned by normals() for each path
+         *
+         * @param first_path Index of the first path in the block
+         * @param num_paths Number of paths in the block
+         * @param first_step First time step to generate
+         * @param num_steps Number of consecutive time steps
+         * @param out Output buffer of at least num_paths * num_steps doubles
+         */
+        void normals_tile(std::uint64_t first_path, int num_paths, std::uint64_t first_step, int num_steps, double* out) const;
+
+    private:
+        std::uint64_t seed_value = 0;
+        PhiloxKey key{};
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * Runtime SIMD dispatch for hot loops
+ *
+ * Functions marked SIMD_DISPATCH are compiled once per listed instruction
+ * set and the best version for the running CPU is selected at load time,
+ * so a single binary uses AVX-512 or AVX2 where available and falls back
+ * to the baseline scalar/SSE2 build elsewhere. The loops themselves are
+ * written as plain, branch-free C++ for the compiler to vectorize.
+ */
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__) && defined(__linux__)
+#define SIMD_DISPATCH __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define SIMD_DISPATCH
+#endif
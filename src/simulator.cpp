@@ -2,7 +2,25 @@
 #include <random>
 #include <chrono>
 #include <fstream> // write to csv
+#include <cstdio> // for std::remove
 #include "math.h" // function declarations for math formulas
+#include "path_store.h" // contiguous storage for simulated paths
+#include "rng.h" // counter-based random number generation
+#include "sobol.h" // quasi-random paths with a Brownian bridge
+#include "payoff.h" // payoff set and fused reduction
+#include "strike_ladder.h" // option-chain pricing from sorted terminal prices
+#include "control_variate.h" // control-variate correction with analytic prices
+#include "greeks.h" // pathwise and likelihood-ratio greeks in the same pass
+#include "bump_greeks.h" // bump-and-revalue greeks with common random numbers
+#include "aad_greeks.h" // adjoint sensitivities to every model input
+#include "portfolio.h" // contracts for batch pricing
+#include "black_scholes_batch.h" // vectorized analytic prices and greeks for chains
+#include "implied_vol.h" // batch implied volatility solver
+#include "column_writer.h" // binary columnar and text export
+#include "batch_averages.h" // averaged paths accumulated during simulation
+#include "async_writer.h" // background output stage
+#include "replay_file.h" // saved scenario sets for repricing without simulating
+#include <iomanip> // for std::setw
 #include <omp.h>
 
 /**
@@ -20,16 +38,59 @@ class Simulator {
         double interest_rate;
         
         // Simulation parameters
-        int num_paths;
+        int num_paths;  // path budget; the target-error mode may stop earlier
+        int paths_simulated = 0;  // paths actually simulated by the last run
+        double target_std_error = 0.0;  // 0 = run all num_paths
+        bool antithetic = false;  // pair every path with its mirror image (-Z)
         int num_steps;
         double dt = time_to_expiration / num_steps;
+        bool store_paths = false;  // keep every full path in path_data
+        std::string path_file;  // file path_data is mapped from, empty to keep the paths in memory
+        bool single_precision = false;  // store path prices (full paths, plotted averages) as float32
+        bool visualize = true;  // accumulate averaged paths for the plot while simulating
+        GbmStep gbm_step;  // precomputed drift/diffusion per step
+        GbmStep terminal_step;  // drift/diffusion over the whole time to expiration
 
         // Random number generation
-        std::random_device rd;
+        static constexpr int RNG_BLOCK = 64;  // steps generated per call to the generator
+        static constexpr int PATH_BLOCK = 16;  // paths advanced together by the GBM kernel (two cache lines)
+        static constexpr int CHUNK_PATHS = 4096;  // paths per partial payoff reduction (multiple of PATH_BLOCK)
+        static constexpr int ROUND_CHUNKS = 16;  // chunks simulated between standard error checks
+        PathRng rng;
+        int sampling = 1;  // 1 = pseudo-random, 2 = Sobol, 3 = Owen-scrambled Sobol
+        SobolPaths sobol;  // configured when sampling != 1
+        std::uint64_t sobol_scramble = 0;  // scrambling seed sobol was built with
 
         // Storage for simulation results
         std::vector<double> final_prices;  // Final price of each path
-        std::vector<std::vector<double>> path_data; // 2D array: [time_step][path_number]
+        std::vector<Payoff> payoffs;  // payoffs priced by every run, followed by control-only payoffs
+        int num_priced = 0;  // number of payoffs reported to the user
+        bool use_control_variates = false;  // correct estimates with Black-Scholes control variates
+        bool price_asian = false;  // also price arithmetic-average Asian options
+        PayoffReduction results;  // discounting-free payoff sums of the last run
+        bool compute_greeks = false;  // estimate delta, gamma and vega alongside the prices
+        GreekReduction greeks;  // greek estimators of the last run
+        bool bump_greeks = false;  // also simulate bumped scenarios on the same normals
+        BumpScenarios scenarios;  // market scenarios of the bump-and-revalue greeks
+        BumpReduction bumped;  // finite-difference greeks of the last run
+        BatchLayout batch_layout;  // paths averaged into each plotted line
+        std::vector<double> batch_sums;  // [time_step][batch] price sums of the last run (only when visualize)
+
+        /**
+         * Everything one chunk of paths reduces into, merged in chunk order after each round
+         */
+        struct ChunkPartials {
+            PayoffReduction payoffs;
+            GreekReduction greeks;
+            BumpReduction bumps;
+            BatchAccumulator batches;
+        };
+        std::vector<ChunkPartials> partials;  // per-chunk reductions, reused across runs
+        bool adjoint_greeks = false;  // differentiate the simulated paths with AAD after pricing
+        AadReduction adjoints;  // adjoint sensitivities of the last run
+        std::vector<AadReduction> adjoint_partials;  // per-chunk adjoint reductions, reused across runs
+        PathStore path_data; // contiguous paths, generated as [time_step][path_number] (only when store_paths)
+        std::string replay_source;  // replay file the scenarios were loaded from, empty when they are simulated
     
     public:
         Simulator() { }
@@ -58,26 +119,193 @@ class Simulator {
             std::cout << "Number of simulation paths (e.g., 100000): ";
             std::cin >> num_paths;
         
-            std::cout << "Number of time steps per path (max allowed: 1000): ";
+            std::cout << "Use antithetic variates? (1 for yes, 0 for no): ";
+            std::cin >> antithetic;
+            if (antithetic && num_paths % 2 != 0) {
+                num_paths++;  // paths come in pairs
+            }
+
+            std::cout << "Use Black-Scholes control variates? (1 for yes, 0 for no): ";
+            std::cin >> use_control_variates;
+
+            std::cout << "Target standard error (e.g., 0.01; 0 to always run every path): ";
+            std::cin >> target_std_error;
+
+            std::cout << "Random seed (0 for a random seed): ";
+            std::uint64_t seed;
+            std::cin >> seed;
+            if (seed == 0) {
+                seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+            }
+            rng.set_seed(seed);
+
+            std::cout << "Sampling method (1 for pseudo-random, 2 for Sobol quasi-random, 3 for scrambled Sobol): ";
+            std::cin >> sampling;
+
+            std::cout << "Path output (0 for terminal prices only, 1 for averaged paths for visualization, "
+                         "2 to also keep every full path in memory, 3 to write every full path to a memory-mapped file): ";
+            int path_output;
+            std::cin >> path_output;
+            visualize = path_output >= 1;
+            store_paths = path_output >= 2;
+            path_file = path_output == 3 ? "dist/Paths.bin" : "";
+            if (visualize) {
+                std::cout << "Store path prices in single precision (float32, half the memory)? (1 for yes, 0 for no): ";
+                std::cin >> single_precision;
+            }
+
+            std::cout << "Also price arithmetic-average Asian options? (1 for yes, 0 for no): ";
+            std::cin >> price_asian;
+
+            std::cout << "Estimate delta, gamma and vega in the same pass? (1 for yes, 0 for no): ";
+            std::cin >> compute_greeks;
+
+            std::cout << "Estimate bump-and-revalue greeks on the same random numbers? (1 for yes, 0 for no): ";
+            std::cin >> bump_greeks;
+
+            std::cout << "Estimate adjoint (AAD) sensitivities to every input? (1 for yes, 0 for no): ";
+            std::cin >> adjoint_greeks;
+
+            if (store_paths && path_file.empty()) {
+                std::cout << "Number of time steps per path (max allowed: 1000): ";
+            } else {
+                std::cout << "Number of time steps per path: ";
+            }
             std::cin >> num_steps;
         
-            if (num_steps > 1000) {
-                std::cout << "Capping time steps to 1000 due to performance constraints.\n";
+            // Full path storage needs num_paths * num_steps doubles in memory; a path file
+            // is paged out by the kernel and streaming mode stores nothing, so neither is capped
+            if (store_paths && path_file.empty() && num_steps > 1000) {
+                std::cout << "Capping time steps to 1000 due to memory constraints.\n";
                 num_steps = 1000;
             }
-        
-            // Initialize data structures
-            path_data.resize(num_steps, std::vector<double>(num_paths));
-            final_prices.resize(num_paths);
+
+            configure();
+
+            if (exact_terminal()) {
+                std::cout << "Only path-independent payoffs requested: sampling terminal prices exactly in one step per path.\n";
+            }
+        }
+
+        /**
+         * Replaces the market parameters of the contract for the next run
+         * Call configure() afterwards
+         */
+        void set_market_parameters(double spot, double strike, double expiry, double vol, double rate) {
+            asset_price = spot;
+            strike_price = strike;
+            time_to_expiration = expiry;
+            volatility = vol;
+            interest_rate = rate;
+        }
+
+        /**
+         * Sets up a streaming, pseudo-random run of one portfolio contract
+         * (no path storage, no prompts) and configures the engine for it
+         */
+        void configure_contract(const Contract& contract) {
+            set_market_parameters(contract.asset_price, contract.strike_price, contract.time_to_expiration,
+                                  contract.volatility, contract.interest_rate);
+            num_paths = contract.num_paths;
+            num_steps = contract.num_steps;
+            price_asian = contract.price_asian;
+            std::uint64_t seed = contract.seed;
+            if (seed == 0) {
+                seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+            }
+            rng.set_seed(seed);
+
+            antithetic = false;
+            use_control_variates = false;
+            target_std_error = 0.0;
+            sampling = 1;
+            store_paths = false;
+            visualize = false;
+            single_precision = false;
+            compute_greeks = false;
+            bump_greeks = false;
+            adjoint_greeks = false;
+            configure();
+        }
+
+        /**
+         * Derives the per-run state (step coefficients, payoff set) from the current
+         * parameters and sizes the buffers
+         * The engine is meant to be reused: path storage, final prices, the partial
+         * reductions and the Sobol tables are only reallocated or rebuilt when the
+         * new shape no longer fits, so repricing the same contract shape does not allocate
+         * Throws std::runtime_error if the path file cannot be created
+         */
+        void configure() {
+            if (store_paths && replay_source.empty()) {
+                if (!path_file.empty()) {
+                    path_data.back_with_file(path_file);
+                }
+                path_data.resize(num_paths, num_steps, PathLayout::StepMajor, path_precision());
+            }
+            if (visualize) {
+                batch_layout = BatchLayout(num_paths);
+            }
+            final_prices.reserve(num_paths);
             dt = time_to_expiration / num_steps;
+            gbm_step = make_gbm_step(interest_rate, volatility, dt);
+            terminal_step = make_gbm_step(interest_rate, volatility, time_to_expiration);
+
+            // Payoffs priced together in one fused pass, listed in display order
+            payoffs = {{PayoffType::Put, strike_price}, {PayoffType::Call, strike_price}};
+            if (price_asian) {
+                payoffs.push_back({PayoffType::AsianPut, strike_price});
+                payoffs.push_back({PayoffType::AsianCall, strike_price});
+            }
+            num_priced = payoffs.size();
+            if (use_control_variates) {
+                payoffs.push_back({PayoffType::Forward, 0.0});  // S_T itself, E[S_T] = S_0 * e^(rT)
+            }
+            scenarios = BumpScenarios(asset_price, interest_rate, volatility, time_to_expiration,
+                                      exact_terminal() ? 1 : num_steps);
+
+            if (sampling != 1 && replay_source.empty()) {
+                // One Sobol dimension per simulated step
+                int dims = exact_terminal() ? 1 : num_steps;
+                std::uint64_t scramble = sampling == 3 ? rng.seed() : 0;
+                if (sobol.steps() != dims || sobol_scramble != scramble) {
+                    sobol = SobolPaths(dims, scramble);
+                    sobol_scramble = scramble;
+                }
+            }
+        }
+
+        /**
+         * Precision of stored path prices; the simulation itself always runs in double
+         */
+        PathPrecision path_precision() const {
+            return single_precision ? PathPrecision::Float32 : PathPrecision::Float64;
+        }
+
+        /**
+         * Returns true if any requested payoff needs the average price along the path
+         */
+        bool needs_average() const {
+            return std::any_of(payoffs.begin(), payoffs.end(),
+                               [](const Payoff& payoff) { return is_path_dependent(payoff.type); });
+        }
+
+        /**
+         * Returns true when the terminal price can be sampled directly
+         * Under GBM, ln(S_T) is normal with known mean and variance, so vanilla
+         * payoffs need one draw per path instead of num_steps. Intermediate
+         * prices are still needed for path-dependent payoffs, stored paths and visualization.
+         * Replayed scenarios are not sampled at all; num_steps is then the saved step count
+         */
+        bool exact_terminal() const {
+            return replay_source.empty() && !store_paths && !visualize && !needs_average();
         }
         
         /**
          * Displays simulation results comparing Monte Carlo vs Black-Scholes
          */
         void output_results() {
-            double put_price = calculate_put_price(final_prices, strike_price, interest_rate, time_to_expiration);
-            double call_price = calculate_call_price(final_prices, strike_price, interest_rate, time_to_expiration);
+            double discount = std::exp(-interest_rate * time_to_expiration);
         
             double analytical_put = black_scholes_put(asset_price, strike_price, interest_rate, volatility, time_to_expiration);
             double analytical_call = black_scholes_call(asset_price, strike_price, interest_rate, volatility, time_to_expiration);
@@ -85,135 +313,901 @@ class Simulator {
             std::cout << "\n====================== Results ======================\n";
         
             std::cout << ">> Monte Carlo Simulation\n";
-            std::cout << "Estimated Put Price  : " << put_price << "\n";
-            std::cout << "Estimated Call Price : " << call_price << "\n";
+            for (int i = 0; i < num_priced; i++) {
+                std::string label = "Estimated " + payoff_name(payoffs[i].type) + " Price";
+                Estimate est = estimate(i);
+                double price = discount * est.mean;
+                double std_error = discount * est.std_error;
+                std::cout << std::left << std::setw(27) << label << ": " << price
+                          << "  (std err " << std_error << ", 95% CI " << price - 1.96 * std_error
+                          << " to " << price + 1.96 * std_error << ")\n";
+            }
+        
+            if (compute_greeks) {
+                std::cout << ">> Monte Carlo Greeks (pathwise; likelihood ratio for gammas and digitals)\n";
+                const std::pair<Greek, const char*> reported[] = {{Greek::Delta, "Delta"}, {Greek::Gamma, "Gamma"}, {Greek::Vega, "Vega"}};
+                for (int i = 0; i < num_priced; i++) {
+                    for (const auto& [greek, name] : reported) {
+                        std::string label = payoff_name(payoffs[i].type) + " " + name;
+                        std::cout << std::left << std::setw(27) << label << ": " << discount * greeks.mean(i, greek)
+                                  << "  (std err " << discount * greeks.std_error(i, greek) << ")\n";
+                    }
+                }
+            }
+
+            if (bump_greeks) {
+                std::cout << ">> Bump-and-Revalue Greeks (common random numbers)\n";
+                const std::pair<Greek, const char*> reported[] = {{Greek::Delta, "Delta"}, {Greek::Gamma, "Gamma"}, {Greek::Vega, "Vega"},
+                                                                  {Greek::Rho, "Rho"}, {Greek::Theta, "Theta"}};
+                for (int i = 0; i < num_priced; i++) {
+                    for (const auto& [greek, name] : reported) {
+                        std::string label = payoff_name(payoffs[i].type) + " " + name;
+                        std::cout << std::left << std::setw(27) << label << ": " << bumped.mean(i, greek)
+                                  << "  (std err " << bumped.std_error(i, greek) << ")\n";
+                    }
+                }
+            }
+
+            if (adjoint_greeks) {
+                std::cout << ">> Adjoint (AAD) Sensitivities (pathwise)\n";
+                for (int i = 0; i < num_priced; i++) {
+                    AadSensitivities sens = adjoints.sensitivities(i);
+                    const std::pair<const char*, double> reported[] = {{"Delta", sens.delta}, {"Vega", sens.vega()},
+                                                                       {"Rho", sens.rho}, {"Theta", sens.theta},
+                                                                       {"dPrice/dStrike", sens.strike}};
+                    for (const auto& [name, value] : reported) {
+                        std::string label = payoff_name(payoffs[i].type) + " " + name;
+                        std::cout << std::left << std::setw(27) << label << ": " << value << "\n";
+                    }
+                }
+            }
+
+            std::cout << std::left << std::setw(27) << "Paths Simulated" << ": " << paths_simulated;
+            if (antithetic) {
+                std::cout << " (" << paths_simulated / 2 << " antithetic pairs)";
+            }
+            if (target_std_error > 0.0) {
+                std::cout << (max_std_error() <= target_std_error ? " (target std err reached)" : " (path budget exhausted before target)");
+            }
+            std::cout << "\n";
+            if (!replay_source.empty()) {
+                std::cout << std::left << std::setw(27) << "Replayed From" << ": " << replay_source
+                          << " (payoff stage only, no paths simulated)\n";
+            }
+        
+            if (use_control_variates) {
+                std::cout << std::left << std::setw(27) << "Control Variates" << ": terminal price, vanilla option for Asians\n";
+            }
+            if (sampling != 1) {
+                std::cout << std::left << std::setw(27) << "Sampling" << ": " << (sampling == 3 ? "scrambled " : "")
+                          << "Sobol with Brownian bridge (std err assumes independent paths, so it overstates QMC error)\n";
+            }
+            std::cout << std::left << std::setw(27) << "Random Seed" << ": " << rng.seed() << "\n";
+            std::cout << std::left << std::setw(27) << "Steps Per Path" << ": " << (exact_terminal() ? 1 : num_steps)
+                      << (exact_terminal() ? " (exact terminal sampling)" : "") << "\n";
         
             std::cout << "\n>> Black-Scholes Analytical Solution\n";
             std::cout << "Analytical Put Price  : " << analytical_put << "\n";
             std::cout << "Analytical Call Price : " << analytical_call << "\n";
+            if (compute_greeks || bump_greeks || adjoint_greeks) {
+                OptionChain chain;
+                chain.spot = asset_price;
+                chain.rate = interest_rate;
+                chain.add_slice(time_to_expiration, {strike_price}, {volatility});
+                BsGreeks analytic;
+                black_scholes_chain(chain, analytic);
+                std::cout << "Analytical Put Delta  : " << analytic.put_delta[0] << "\n";
+                std::cout << "Analytical Call Delta : " << analytic.call_delta[0] << "\n";
+                std::cout << "Analytical Gamma      : " << analytic.gamma[0] << "\n";
+                std::cout << "Analytical Vega       : " << analytic.vega[0] << "\n";
+                if (bump_greeks || adjoint_greeks) {
+                    std::cout << "Analytical Put Rho    : " << analytic.put_rho[0] << "\n";
+                    std::cout << "Analytical Call Rho   : " << analytic.call_rho[0] << "\n";
+                    std::cout << "Analytical Put Theta  : " << analytic.put_theta[0] << "\n";
+                    std::cout << "Analytical Call Theta : " << analytic.call_theta[0] << "\n";
+                }
+            }
         
             std::cout << "=====================================================\n";
         } 
 
+        /**
+         * Fills a [step][lane] tile of normals for the paths of a block
+         * In antithetic mode the first half of the lanes draws the normals of
+         * pair indices first_path/2 onwards and the second half mirrors them (-Z),
+         * so each drawn normal drives two paths
+         * With quasi-random sampling the normals are copied from the block's
+         * precomputed Brownian-bridge tile instead of the pseudo-random generator
+         */
+        void draw_normals(int first_path, int lanes, int first_step, int count, double* Z, const double* qmc_tile) const {
+            int drawn_lanes = antithetic ? lanes / 2 : lanes;
+            alignas(64) double drawn[RNG_BLOCK * PATH_BLOCK];
+            double* target = antithetic ? drawn : Z;
+
+            if (qmc_tile) {
+                std::copy(qmc_tile + static_cast<std::size_t>(first_step) * drawn_lanes,
+                          qmc_tile + static_cast<std::size_t>(first_step + count) * drawn_lanes, target);
+            } else {
+                rng.normals_tile(antithetic ? first_path / 2 : first_path, drawn_lanes, first_step, count, target);
+            }
+            if (!antithetic) return;
+
+            int half = drawn_lanes;
+            for (int k = 0; k < count; k++) {
+                for (int lane = 0; lane < half; lane++) {
+                    Z[k * lanes + lane] = drawn[k * half + lane];
+                    Z[k * lanes + half + lane] = -drawn[k * half + lane];
+                }
+            }
+        }
+
+        /**
+         * Quasi-random paths need every step's normal up front for the Brownian bridge
+         * Returns the block's [step][lane] tile of normals (in a per-thread buffer), or
+         * null with pseudo-random sampling
+         */
+        const double* quasi_random_tile(int first_path, int lanes) const {
+            if (sampling == 1) return nullptr;
+            thread_local std::vector<double> qmc_tile;
+            int drawn_lanes = antithetic ? lanes / 2 : lanes;
+            qmc_tile.resize(static_cast<std::size_t>(sobol.steps()) * drawn_lanes);
+            sobol.normals_tile(antithetic ? first_path / 2 : first_path, drawn_lanes, qmc_tile.data());
+            return qmc_tile.data();
+        }
+
+        /**
+         * Simulates a block of up to PATH_BLOCK consecutive paths, stores their terminal prices
+         * and adds their payoffs to the given partial reduction
+         * Normals come from the counter-based generator keyed by (seed, path, step),
+         * so the result does not depend on which thread runs the block
+         * Paths are advanced together in log space; prices are only exponentiated
+         * when observed (stored, averaged) and at expiration
+         * In streaming mode each path keeps only its running state and hands the terminal value to the payoff stage
+         */
+        void simulate_block(int first_path, ChunkPartials& partial) {
+            int lanes = std::min(PATH_BLOCK, num_paths - first_path);
+            bool track_average = needs_average();
+            bool track_vega = compute_greeks && track_average;
+            double log_spot = std::log(asset_price);
+            alignas(64) double log_prices[PATH_BLOCK];
+            alignas(64) double Z[RNG_BLOCK * PATH_BLOCK];  // [step][lane] normals, then log prices
+            alignas(64) double terminal[PATH_BLOCK];
+            alignas(64) double averages[PATH_BLOCK] = {};  // running sums, then the Asian average
+            alignas(64) double average_vega[PATH_BLOCK] = {};  // running sums of dS_t/dsigma, then their average
+            alignas(64) double first_normal[PATH_BLOCK];  // normal of the first step (Asian gamma score)
+            alignas(64) double brownian[PATH_BLOCK];  // W_T, recovered from the terminal log price
+            constexpr int SCENARIO_LANES = BumpScenarios::NUM_SCENARIOS * PATH_BLOCK;
+            alignas(64) double scenario_prices[SCENARIO_LANES];  // [scenario][lane] log prices, then terminal prices
+            alignas(64) double scenario_averages[SCENARIO_LANES];  // [scenario][lane] running sums, then averages
+            double* scenario_sums = track_average ? scenario_averages : nullptr;
+
+            alignas(64) int lane_batch[PATH_BLOCK];  // plotted line of each lane, relative to the chunk's first
+            alignas(64) double step_prices[PATH_BLOCK];  // prices of one step, before rounding to the stored precision
+
+            for (int lane = 0; lane < lanes; lane++) {
+                log_prices[lane] = log_spot;
+                lane_batch[lane] = visualize ? batch_layout.batch_of(first_path + lane) - partial.batches.first_batch() : 0;
+            }
+            if (bump_greeks) {
+                scenarios.start(scenario_prices, scenario_sums, PATH_BLOCK);
+            }
+
+            const double* qmc = quasi_random_tile(first_path, lanes);
+
+            if (exact_terminal()) {
+                // One step covering the whole life of the option: ln(S_T) = ln(S_0) + (r - sigma^2/2)T + sigma*sqrt(T)*Z
+                draw_normals(first_path, lanes, 0, 1, Z, qmc);
+                if (bump_greeks) {
+                    scenarios.advance(scenario_prices, nullptr, Z, lanes, PATH_BLOCK, 1);
+                }
+                advance_log_prices(terminal_step, log_prices, Z, lanes, 1);
+            } else {
+                for (int j0 = 0; j0 < num_steps; j0 += RNG_BLOCK) {
+                    int count = std::min(RNG_BLOCK, num_steps - j0);
+                    draw_normals(first_path, lanes, j0, count, Z, qmc);
+                    if (j0 == 0) {
+                        std::copy(Z, Z + lanes, first_normal);
+                    }
+                    if (bump_greeks) {
+                        // Same normals as the base path, before they are overwritten with its log prices
+                        scenarios.advance(scenario_prices, scenario_sums, Z, lanes, PATH_BLOCK, count);
+                    }
+                    advance_log_prices(gbm_step, log_prices, Z, lanes, count);
+
+                    if (store_paths || visualize || track_average) {
+                        for (int k = 0; k < count; k++) {
+                            double* step_sums = visualize ? partial.batches.row(j0 + k) : nullptr;
+                            for (int lane = 0; lane < lanes; lane++) {
+                                double price = std::exp(Z[k * lanes + lane]);
+                                averages[lane] += price;
+                                step_prices[lane] = price;
+                                if (step_sums) step_sums[lane_batch[lane]] += price;
+                            }
+                            if (store_paths) {
+                                path_data.store(j0 + k, first_path, step_prices, lanes);
+                            }
+                            if (track_vega) {
+                                // dS_t/dsigma = S_t (W_t - sigma t) = S_t (ln(S_t/S_0) - (r + sigma^2/2) t) / sigma
+                                double t = (j0 + k + 1) * dt;
+                                double offset = log_spot + (interest_rate + 0.5 * volatility * volatility) * t;
+                                for (int lane = 0; lane < lanes; lane++) {
+                                    double log_price = Z[k * lanes + lane];
+                                    average_vega[lane] += std::exp(log_price) * (log_price - offset) / volatility;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (int lane = 0; lane < lanes; lane++) {
+                terminal[lane] = std::exp(log_prices[lane]);
+                averages[lane] /= num_steps;
+                final_prices[first_path + lane] = terminal[lane];  // Keep final price for later analysis
+            }
+
+            // Price every payoff while the block is still in L1
+            if (antithetic) {
+                partial.payoffs.add_antithetic(payoffs, terminal, track_average ? averages : nullptr, lanes / 2);
+            } else {
+                partial.payoffs.add(payoffs, terminal, track_average ? averages : nullptr, lanes);
+            }
+
+            if (compute_greeks) {
+                double drift = (interest_rate - 0.5 * volatility * volatility) * time_to_expiration;
+                for (int lane = 0; lane < lanes; lane++) {
+                    brownian[lane] = (log_prices[lane] - log_spot - drift) / volatility;
+                    average_vega[lane] /= num_steps;
+                }
+                PathSensitivities sensitivities = {terminal, track_average ? averages : nullptr, brownian,
+                                                   track_average ? first_normal : nullptr,
+                                                   track_vega ? average_vega : nullptr};
+                if (antithetic) {
+                    partial.greeks.add_antithetic(payoffs, sensitivities, lanes / 2);
+                } else {
+                    partial.greeks.add(payoffs, sensitivities, lanes);
+                }
+            }
+
+            if (bump_greeks) {
+                scenarios.finish(scenario_prices, scenario_sums, lanes, PATH_BLOCK);
+                if (antithetic) {
+                    partial.bumps.add_antithetic(payoffs, scenario_prices, scenario_sums, PATH_BLOCK, lanes / 2);
+                } else {
+                    partial.bumps.add(payoffs, scenario_prices, scenario_sums, PATH_BLOCK, lanes);
+                }
+            }
+        }
+
+        /**
+         * Undiscounted estimate of payoff i from the last run
+         * With control variates, every payoff is corrected using the simulated
+         * terminal price (E[S_T] = S_0 * e^(rT)); path-dependent payoffs also use
+         * the vanilla option of the same direction and strike, whose expectation
+         * is the Black-Scholes price grown at the risk-free rate
+         */
+        Estimate estimate(int i) const {
+            if (!use_control_variates) {
+                return {results.mean(i), results.std_error(i)};
+            }
+
+            double growth = std::exp(interest_rate * time_to_expiration);
+            std::vector<int> controls = {static_cast<int>(payoffs.size()) - 1};
+            std::vector<double> expected = {asset_price * growth};
+
+            if (is_path_dependent(payoffs[i].type)) {
+                bool is_call = payoffs[i].type == PayoffType::AsianCall;
+                PayoffType vanilla = is_call ? PayoffType::Call : PayoffType::Put;
+                double K = payoffs[i].strike;
+                for (int j = 0; j < num_priced; j++) {
+                    if (payoffs[j].type == vanilla && payoffs[j].strike == K) {
+                        controls.push_back(j);
+                        expected.push_back(growth * (is_call
+                            ? black_scholes_call(asset_price, K, interest_rate, volatility, time_to_expiration)
+                            : black_scholes_put(asset_price, K, interest_rate, volatility, time_to_expiration)));
+                        break;
+                    }
+                }
+            }
+            return control_variate_estimate(results, i, controls, expected);
+        }
+
+        /**
+         * Discounted price and standard error of the first priced payoff of the given type
+         * Returns a NaN price if the payoff type is not priced by this run
+         */
+        Estimate discounted_estimate(PayoffType type) const {
+            double discount = std::exp(-interest_rate * time_to_expiration);
+            for (int i = 0; i < num_priced; i++) {
+                if (payoffs[i].type == type) {
+                    Estimate est = estimate(i);
+                    return {discount * est.mean, discount * est.std_error};
+                }
+            }
+            return {std::nan(""), std::nan("")};
+        }
+
+        /**
+         * Largest discounted standard error over all reported payoffs
+         */
+        double max_std_error() const {
+            double discount = std::exp(-interest_rate * time_to_expiration);
+            double worst = 0.0;
+            for (int i = 0; i < num_priced; i++) {
+                worst = std::max(worst, discount * estimate(i).std_error);
+            }
+            return worst;
+        }
+
+        /**
+         * Simulates all paths, optionally spread over the OpenMP thread team
+         * Paths are reduced in fixed chunks of CHUNK_PATHS whose partial statistics are
+         * merged in chunk order, so prices do not depend on the number of threads
+         * With a target standard error, chunks are simulated in rounds of ROUND_CHUNKS
+         * and the run stops as soon as every payoff meets the target (num_paths is the budget)
+         */
+        void run_simulation(bool parallel) {
+            if (store_paths) {
+                path_data.resize(num_paths, num_steps, PathLayout::StepMajor, path_precision());  // undoes the truncation of the last run
+            }
+            final_prices.resize(num_paths);
+
+            int num_chunks = (num_paths + CHUNK_PATHS - 1) / CHUNK_PATHS;
+            int round_chunks = target_std_error > 0.0 ? ROUND_CHUNKS : num_chunks;
+            results.reset(payoffs, use_control_variates);
+            paths_simulated = 0;
+            if (static_cast<int>(partials.size()) < round_chunks) {
+                partials.resize(round_chunks);
+            }
+            GreekModel model = {asset_price, interest_rate, volatility, time_to_expiration,
+                                exact_terminal() ? time_to_expiration : dt};
+            greeks.reset(compute_greeks ? payoffs : std::vector<Payoff>(), model);
+            bumped.reset(bump_greeks ? payoffs : std::vector<Payoff>(), scenarios);
+            batch_sums.assign(visualize ? static_cast<std::size_t>(num_steps) * batch_layout.size() : 0, 0.0);
+
+            for (int first_chunk = 0; first_chunk < num_chunks; first_chunk += round_chunks) {
+                int last_chunk = std::min(first_chunk + round_chunks, num_chunks);
+                for (int chunk = first_chunk; chunk < last_chunk; chunk++) {
+                    ChunkPartials& partial = partials[chunk - first_chunk];
+                    partial.payoffs.reset(payoffs, use_control_variates);
+                    partial.greeks.reset(compute_greeks ? payoffs : std::vector<Payoff>(), model);
+                    partial.bumps.reset(bump_greeks ? payoffs : std::vector<Payoff>(), scenarios);
+                    if (visualize) {
+                        partial.batches.reset(batch_layout, chunk * CHUNK_PATHS,
+                                              std::min((chunk + 1) * CHUNK_PATHS, num_paths), num_steps);
+                    }
+                }
+
+                #pragma omp parallel for schedule(static) if(parallel)
+                for (int chunk = first_chunk; chunk < last_chunk; chunk++) {
+                    int chunk_end = std::min((chunk + 1) * CHUNK_PATHS, num_paths);
+                    for (int i = chunk * CHUNK_PATHS; i < chunk_end; i += PATH_BLOCK) {
+                        simulate_block(i, partials[chunk - first_chunk]);
+                    }
+                }
+
+                for (int chunk = first_chunk; chunk < last_chunk; chunk++) {
+                    const ChunkPartials& partial = partials[chunk - first_chunk];
+                    results.merge(partial.payoffs);
+                    greeks.merge(partial.greeks);
+                    bumped.merge(partial.bumps);
+                    if (visualize) {
+                        partial.batches.merge_into(batch_sums, batch_layout.size());
+                    }
+                }
+                paths_simulated = std::min(last_chunk * CHUNK_PATHS, num_paths);
+
+                if (target_std_error > 0.0 && max_std_error() <= target_std_error) break;
+            }
+
+            if (adjoint_greeks) {
+                run_adjoint(parallel);
+            }
+
+            final_prices.resize(paths_simulated);
+            if (store_paths) {
+                path_data.truncate(paths_simulated);
+            }
+        }
+
+        /**
+         * Differentiates the simulated paths with AAD
+         * Every path is regenerated from the same normals as the pricing run and
+         * recorded on the tape of the thread that owns its chunk; chunk results are
+         * merged in chunk order like the payoff partials
+         */
+        void run_adjoint(bool parallel) {
+            int steps = exact_terminal() ? 1 : num_steps;
+            AadModel model = {asset_price, strike_price, interest_rate, time_to_expiration,
+                              std::vector<double>(steps, volatility)};
+            int num_chunks = (paths_simulated + CHUNK_PATHS - 1) / CHUNK_PATHS;
+            adjoints.reset(payoffs, model);
+            if (static_cast<int>(adjoint_partials.size()) < num_chunks) {
+                adjoint_partials.resize(num_chunks);
+            }
+
+            #pragma omp parallel for schedule(static) if(parallel)
+            for (int chunk = 0; chunk < num_chunks; chunk++) {
+                thread_local std::vector<double> Z;  // [step][lane] normals of one block
+                Z.resize(static_cast<std::size_t>(steps) * PATH_BLOCK);
+                AadReduction& partial = adjoint_partials[chunk];
+                partial.reset(payoffs, model);
+                partial.begin();
+                int chunk_end = std::min((chunk + 1) * CHUNK_PATHS, paths_simulated);
+                for (int i = chunk * CHUNK_PATHS; i < chunk_end; i += PATH_BLOCK) {
+                    int lanes = std::min(PATH_BLOCK, paths_simulated - i);
+                    const double* qmc = quasi_random_tile(i, lanes);
+                    for (int j0 = 0; j0 < steps; j0 += RNG_BLOCK) {
+                        draw_normals(i, lanes, j0, std::min(RNG_BLOCK, steps - j0), Z.data() + j0 * lanes, qmc);
+                    }
+                    partial.add(payoffs, Z.data(), lanes);
+                }
+                partial.end();
+            }
+
+            for (int chunk = 0; chunk < num_chunks; chunk++) {
+                adjoints.merge(adjoint_partials[chunk]);
+            }
+        }
+
         /**
          * Runs Monte Carlo simulation using single-threaded approach
          * Generates asset price paths using geometric Brownian motion
          */
         void run_single_threaded_simulation() {
-            std::mt19937 rng(rd());
-            std::normal_distribution<double> dist(0.0, 1.0);
-
-            // Generate num_paths price trajectories
-            for (int i = 0; i < num_paths; i++) {
-                double current_price{asset_price};
-
-                // Simulate one complete price path
-                for (int j = 0; j < num_steps; j++) {
-                    double Z = dist(rng);  // Random normal variable
-                    current_price = nextPrice(current_price, interest_rate, volatility, dt, Z);
-                    path_data[j][i] = current_price;
+            run_simulation(false);
+        }
+
+        /**
+         * Runs Monte Carlo simulation using OpenMP parallelization
+         * Blocks share the stateless generator, so no per-thread setup is needed
+         * and the results are bit-identical to the single-threaded run
+         */
+        void run_multi_threaded_simulation() {
+            run_simulation(true);
+        }
+
+        /**
+         * Saves the scenarios of the last run for replay: the generating parameters,
+         * the terminal prices and, when they were kept, every full path
+         * Paths kept in memory are written to paths_file; a path file the run
+         * was mapped from is referenced where it is
+         * Throws std::runtime_error if a file cannot be written
+         *
+         * @param replay_file Replay file to create (see replay_file.h)
+         * @param paths_file Path file for paths kept in memory
+         */
+        void save_replay(const std::string& replay_file, const std::string& paths_file) const {
+            std::string saved_paths;
+            if (store_paths) {
+                saved_paths = path_file.empty() ? paths_file : path_file;
+                if (path_file.empty()) {
+                    path_data.write_file(paths_file);
                 }
-                final_prices[i] = current_price;  // Store final price for option pricing
             }
+            ReplayParameters parameters = {asset_price, strike_price, time_to_expiration, volatility, interest_rate,
+                                           rng.seed(), exact_terminal() ? 1 : num_steps, sampling, antithetic};
+            write_replay(replay_file, parameters, final_prices, saved_paths);
         }
 
         /**
-         * Runs Monte Carlo simulation using OpenMP parallelization
-         * Each thread generates its own random number generator for thread safety
+         * Loads saved scenarios in place of a simulation
+         * The path file, if any, is mapped read-only and checked against the
+         * saved terminal prices, so a file overwritten by a later run is rejected
+         * Throws std::runtime_error if either file cannot be read
+         *
+         * @param replay_file Replay file written by save_replay
          */
-        void run_multi_threaded_simulation() {              
-            #pragma omp parallel for
-            for (int i = 0; i < num_paths; i++) {
-                // Thread-local random number generators for safety
-                std::mt19937 local_rng(rd() + omp_get_thread_num()); 
-                std::normal_distribution<double> local_dist(0.0, 1.0);
-
-                double current_price{asset_price};
-
-                // Simulate one complete price path
-                for (int j = 0; j < num_steps; j++) {
-                    double Z = local_dist(local_rng);
-                    current_price = nextPrice(current_price, interest_rate, volatility, dt, Z);
-                    path_data[j][i] = current_price;
+        void load_replay(const std::string& replay_file) {
+            ReplayRun run = read_replay(replay_file);
+            const ReplayParameters& saved = run.parameters;
+            set_market_parameters(saved.asset_price, saved.strike_price, saved.time_to_expiration,
+                                  saved.volatility, saved.interest_rate);
+            num_steps = saved.num_steps;
+            sampling = saved.sampling;
+            antithetic = saved.antithetic;
+            rng.set_seed(saved.seed);
+            final_prices = std::move(run.terminal_prices);
+            num_paths = paths_simulated = final_prices.size();
+            replay_source = replay_file;
+
+            use_control_variates = false;
+            target_std_error = 0.0;
+            visualize = false;
+            compute_greeks = false;
+            bump_greeks = false;
+            adjoint_greeks = false;
+            store_paths = !run.path_file.empty();
+            if (store_paths) {
+                path_data = PathStore::open_file(run.path_file);
+                int last = paths_simulated - 1;
+                if (path_data.current_layout() != PathLayout::StepMajor || path_data.paths() != paths_simulated ||
+                    path_data.steps() != num_steps || path_data.at(0, num_steps - 1) != path_data.rounded(final_prices[0]) ||
+                    path_data.at(last, num_steps - 1) != path_data.rounded(final_prices[last])) {
+                    throw std::runtime_error("path file '" + run.path_file + "' does not match the scenarios in '" +
+                                             replay_file + "'");
                 }
-                final_prices[i] = current_price;
             }
         }
 
         /**
-         * Exports simulation data to CSV file for visualization
-         * Format: time column + averaged path columns for readability
+         * Asks which payoffs to price on the loaded scenarios and configures the engine for them
          */
-        void write_to_csv() {
-            std::ofstream data("dist/Data.csv");
-            
-            // Calculate target lines dynamically based on number of paths
-            int target_lines;
-            if (num_paths <= 100) {
-                target_lines = num_paths;  // Show all paths for very small datasets
+        void get_replay_input() {
+            std::cout << "\n=== Replayed Scenarios ===\n";
+            std::cout << paths_simulated << " paths, " << num_steps << " steps, S0 = " << asset_price
+                      << ", T = " << time_to_expiration << ", volatility = " << volatility
+                      << ", rate = " << interest_rate << ", seed = " << rng.seed() << "\n";
+
+            std::cout << "Strike price (the saved run used " << strike_price << "): ";
+            std::cin >> strike_price;
+
+            price_asian = false;
+            if (store_paths) {
+                std::cout << "Also price arithmetic-average Asian options? (1 for yes, 0 for no): ";
+                std::cin >> price_asian;
             } else {
-                // Scale using square root: more paths = more lines, but not linearly
-                target_lines = std::max(15, std::min(50, (int)std::sqrt(num_paths)));
-            }
-            
-            int batch_size = std::max(1, num_paths / target_lines);
-            int num_batches = (num_paths + batch_size - 1) / batch_size;
-            
-            // Write column headers
-            data << "time_step,";
-            for (int batch = 0; batch < num_batches; batch++) {
-                int start_idx = batch * batch_size;
-                int end_idx = std::min((batch + 1) * batch_size, num_paths);
-                data << "avg_paths_" << (start_idx + 1) << "-" << end_idx;
-                if (batch != num_batches - 1) data << ",";
-            }
-            data << "\n";
-            
-            // Write price data: each row is a time step, each column is an averaged path
-            for (int i = 0; i < num_steps; i++) {
-                data << i << ",";
-                for (int batch = 0; batch < num_batches; batch++) {
-                    int start_idx = batch * batch_size;
-                    int end_idx = std::min((batch + 1) * batch_size, num_paths);
-                    
-                    // Calculate average of this batch at this time step
-                    double sum = 0.0;
-                    for (int j = start_idx; j < end_idx; j++) {
-                        sum += path_data[i][j];
+                std::cout << "Only terminal prices were saved, so path-dependent payoffs cannot be replayed.\n";
+            }
+
+            std::cout << "Use Black-Scholes control variates? (1 for yes, 0 for no): ";
+            std::cin >> use_control_variates;
+
+            configure();
+        }
+
+        /**
+         * Prices the payoffs on the loaded scenarios without simulating anything
+         * Terminal prices come from the replay file; path averages are summed
+         * in double from the mapped path file, step by step as in the simulation.
+         * Blocks, chunks and the merge order match run_simulation, so replaying the
+         * payoffs of the saved run reproduces its prices exactly (Asian prices to
+         * within the float32 rounding bound of path_store.h when paths were stored in single precision)
+         */
+        void replay_payoffs(bool parallel) {
+            int num_chunks = (paths_simulated + CHUNK_PATHS - 1) / CHUNK_PATHS;
+            bool track_average = needs_average();
+            results.reset(payoffs, use_control_variates);
+            if (static_cast<int>(partials.size()) < num_chunks) {
+                partials.resize(num_chunks);
+            }
+
+            #pragma omp parallel for schedule(static) if(parallel)
+            for (int chunk = 0; chunk < num_chunks; chunk++) {
+                thread_local std::vector<double> averages;  // per-path running sums, then averages
+                int chunk_start = chunk * CHUNK_PATHS;
+                int chunk_end = std::min(chunk_start + CHUNK_PATHS, paths_simulated);
+                PayoffReduction& partial = partials[chunk].payoffs;
+                partial.reset(payoffs, use_control_variates);
+
+                if (track_average) {
+                    // Row by row, so each thread streams through the step-major file front to back
+                    averages.assign(chunk_end - chunk_start, 0.0);
+                    for (int step = 0; step < num_steps; step++) {
+                        path_data.accumulate(step, chunk_start, chunk_end - chunk_start, averages.data());
+                    }
+                    for (double& average : averages) {
+                        average /= num_steps;
+                    }
+                }
+
+                for (int i = chunk_start; i < chunk_end; i += PATH_BLOCK) {
+                    int lanes = std::min(PATH_BLOCK, chunk_end - i);
+                    const double* block_averages = track_average ? &averages[i - chunk_start] : nullptr;
+                    if (antithetic) {
+                        partial.add_antithetic(payoffs, &final_prices[i], block_averages, lanes / 2);
+                    } else {
+                        partial.add(payoffs, &final_prices[i], block_averages, lanes);
                     }
-                    double avg = sum / (end_idx - start_idx);
-                    
-                    data << avg;
-                    if (batch != num_batches - 1) data << ",";
                 }
-                data << "\n";
+            }
+
+            for (int chunk = 0; chunk < num_chunks; chunk++) {
+                results.merge(partials[chunk].payoffs);
             }
         }
 
         /**
-         * Resets simulation data for multiple runs
+         * Snapshot of the averaged paths of the last run for visualization
+         * The batch sums were accumulated during the run, so this never reads the paths themselves
+         * Format: time column + averaged path columns for readability
+         * The averages are computed in double and stored as float32 in single precision mode
+         * The table owns its data, so it can be written while the engine runs again
          */
-        void clear() {
-            for (int i = 0; i < final_prices.size(); i++) {
-                final_prices[i] = 0.0;
-            }
+        ColumnWriter path_averages() const {
+            // Batches past the last simulated path (target-error runs that stopped early) are dropped
+            int num_batches = batch_layout.size();
+            int used_batches = std::min(num_batches, batch_layout.batch_of(std::max(paths_simulated - 1, 0)) + 1);
 
-            for (int i = 0; i < path_data.size(); i++) {
-                for (int j = 0; j < path_data[i].size(); j++) {
-                    path_data[i][j] = 0.0;
+            // Each column is an averaged path, each row a time step
+            std::vector<std::vector<double>> averages(used_batches, std::vector<double>(num_steps));
+            std::vector<int> batch_start(used_batches + 1);
+            for (int batch = 0; batch < used_batches; batch++) {
+                batch_start[batch] = batch_layout.first_path(batch);
+            }
+            batch_start[used_batches] = paths_simulated;
+            for (int i = 0; i < num_steps; i++) {
+                const double* step_sums = &batch_sums[static_cast<std::size_t>(i) * num_batches];
+                for (int batch = 0; batch < used_batches; batch++) {
+                    averages[batch][i] = step_sums[batch] / (batch_start[batch + 1] - batch_start[batch]);
                 }
             }
+
+            ColumnWriter table;
+            std::vector<double> time_steps(num_steps);
+            for (int i = 0; i < num_steps; i++) {
+                time_steps[i] = i;
+            }
+            table.add_column("time_step", std::move(time_steps));
+            for (int batch = 0; batch < used_batches; batch++) {
+                table.add_column("avg_paths_" + std::to_string(batch_start[batch] + 1) + "-" +
+                                 std::to_string(batch_start[batch + 1]), std::move(averages[batch]),
+                                 single_precision ? ColumnType::Float32 : ColumnType::Float64);
+            }
+            return table;
+        }
+
+        /**
+         * Prices a ladder of strikes on the paths of the last run
+         * Sorts the terminal prices once; every strike is then a binary search
+         */
+        void price_option_chain() {
+            std::cout << "\nPrice an option chain on the same paths? Number of strikes (0 to skip): ";
+            int num_strikes;
+            std::cin >> num_strikes;
+            if (num_strikes <= 0) return;
+
+            double low_strike, high_strike;
+            std::cout << "Lowest strike: ";
+            std::cin >> low_strike;
+            std::cout << "Highest strike: ";
+            std::cin >> high_strike;
+
+            auto start = std::chrono::high_resolution_clock::now();
+            StrikeLadder ladder(final_prices, interest_rate, time_to_expiration);
+
+            // Analytic reference for the whole ladder in one vectorized pass
+            std::vector<double> strikes(num_strikes);
+            for (int i = 0; i < num_strikes; i++) {
+                strikes[i] = num_strikes == 1 ? low_strike
+                                              : low_strike + (high_strike - low_strike) * i / (num_strikes - 1);
+            }
+            OptionChain chain;
+            chain.spot = asset_price;
+            chain.rate = interest_rate;
+            chain.add_slice(time_to_expiration, strikes, std::vector<double>(num_strikes, volatility));
+            BsGreeks analytic;
+            black_scholes_chain(chain, analytic);
+
+            // Monte Carlo error expressed in volatility terms: the vol implied by each MC call price
+            std::vector<double> mc_calls(num_strikes);
+            for (int i = 0; i < num_strikes; i++) {
+                mc_calls[i] = ladder.call_price(strikes[i]);
+            }
+            std::vector<double> mc_vols;
+            implied_volatility_chain(chain, mc_calls, std::vector<bool>(num_strikes, true), mc_vols);
+
+            std::cout << "\n=================== Option Chain ====================\n";
+            std::cout << std::left << std::setw(10) << "Strike" << std::setw(11) << "MC Call" << std::setw(11) << "MC Put"
+                      << std::setw(11) << "BS Call" << std::setw(11) << "BS Put" << std::setw(11) << "BS Delta"
+                      << "MC Impl Vol" << "\n";
+            for (int i = 0; i < num_strikes; i++) {
+                double K = strikes[i];
+                std::cout << std::left << std::setw(10) << K
+                          << std::setw(11) << mc_calls[i]
+                          << std::setw(11) << ladder.put_price(K)
+                          << std::setw(11) << analytic.call[i]
+                          << std::setw(11) << analytic.put[i]
+                          << std::setw(11) << analytic.call_delta[i]
+                          << mc_vols[i] << "\n";
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> elapsed = end - start;
+            std::cout << "=====================================================\n";
+            std::cout << "Option Chain Time: " << elapsed.count() << " seconds.\n";
+        }
+
+        /**
+         * Returns true when averaged paths were accumulated and can be exported
+         */
+        bool has_paths() const {
+            return visualize;
+        }
+
+        /**
+         * Returns the file holding every full path of the last run, or an empty string if they were kept in memory
+         */
+        const std::string& full_path_file() const {
+            return path_file;
+        }
+
+        /**
+         * Resets the results of the last run before another one
+         * The buffers are neither freed nor zeroed: the next run overwrites every stored price
+         */
+        void clear() {
+            paths_simulated = 0;
+            results.reset(payoffs, use_control_variates);
+            greeks.reset(compute_greeks ? payoffs : std::vector<Payoff>(), GreekModel());
+            bumped.reset(bump_greeks ? payoffs : std::vector<Payoff>(), scenarios);
         }
 };
 
+/**
+ * Writes averaged paths for visualization, as binary columns (dist/Data.bin,
+ * see column_writer.h) or as CSV text (dist/Data.csv)
+ * The other format's file is removed so readers never pick up stale output
+ *
+ * @param table Averaged paths from Simulator::path_averages
+ * @param text Write CSV instead of the binary layout
+ */
+void write_path_averages(const ColumnWriter& table, bool text) {
+    if (text) {
+        table.write_text("dist/Data.csv");
+        std::remove("dist/Data.bin");
+    } else {
+        table.write_binary("dist/Data.bin");
+        std::remove("dist/Data.csv");
+    }
+}
+
+/**
+ * Prices every contract of a portfolio file and writes one results row per contract
+ * Contracts are spread over the OpenMP thread team; each thread keeps one
+ * engine alive and reuses its buffers for all of its contracts, and each
+ * contract runs single-threaded, which suits books of many small contracts
+ * Contracts are priced in blocks; the rows of one block are formatted and
+ * written by the background writer while the next block is priced
+ *
+ * @param portfolio_file Input portfolio CSV (see portfolio.h)
+ * @param results_file Output CSV
+ * @return Process exit code
+ */
+int run_batch(const std::string& portfolio_file, const std::string& results_file) {
+    std::vector<Contract> contracts;
+    try {
+        contracts = read_portfolio(portfolio_file);
+    } catch (const std::runtime_error& error) {
+        std::cout << "Error: " << error.what() << "\n";
+        return 1;
+    }
+
+    const PayoffType columns[] = {PayoffType::Put, PayoffType::Call, PayoffType::AsianPut, PayoffType::AsianCall};
+    constexpr int NUM_COLUMNS = sizeof(columns) / sizeof(columns[0]);
+    constexpr std::size_t RESULT_BLOCK = 256;  // contracts priced between two handoffs to the writer
+
+    std::ofstream results(results_file);
+    if (!results) {
+        std::cout << "Error: cannot write results file '" << results_file << "'\n";
+        return 1;
+    }
+    results << std::setprecision(10);
+    results << "contract,put,put_std_err,call,call_std_err,asian_put,asian_put_std_err,asian_call,asian_call_std_err,"
+            << "bs_put,bs_call\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<Simulator> engines(omp_get_max_threads());
+    AsyncWriter writer;
+    for (std::size_t first = 0; first < contracts.size(); first += RESULT_BLOCK) {
+        std::size_t last = std::min(first + RESULT_BLOCK, contracts.size());
+        std::vector<Estimate> prices((last - first) * NUM_COLUMNS);
+
+        #pragma omp parallel for schedule(dynamic)
+        for (std::size_t c = first; c < last; c++) {
+            Simulator& sim = engines[omp_get_thread_num()];
+            sim.configure_contract(contracts[c]);
+            sim.run_single_threaded_simulation();
+            for (int k = 0; k < NUM_COLUMNS; k++) {
+                prices[(c - first) * NUM_COLUMNS + k] = sim.discounted_estimate(columns[k]);
+            }
+        }
+
+        // The block's prices move into the job; the next block reuses nothing it holds
+        writer.submit([&results, &contracts, &results_file, first, last, prices = std::move(prices)] {
+            for (std::size_t c = first; c < last; c++) {
+                const Contract& contract = contracts[c];
+                results << c;
+                for (int k = 0; k < NUM_COLUMNS; k++) {
+                    const Estimate& price = prices[(c - first) * NUM_COLUMNS + k];
+                    results << ",";
+                    if (!std::isnan(price.mean)) results << price.mean << "," << price.std_error;
+                    else results << ",";
+                }
+                results << "," << black_scholes_put(contract.asset_price, contract.strike_price, contract.interest_rate,
+                                                     contract.volatility, contract.time_to_expiration)
+                        << "," << black_scholes_call(contract.asset_price, contract.strike_price, contract.interest_rate,
+                                                      contract.volatility, contract.time_to_expiration) << "\n";
+            }
+            results.flush();
+            if (!results) {
+                throw std::runtime_error("cannot write results file '" + results_file + "'");
+            }
+        });
+    }
+
+    try {
+        writer.flush();
+    } catch (const std::runtime_error& error) {
+        std::cout << "Error: " << error.what() << "\n";
+        return 1;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+
+    std::cout << "Priced " << contracts.size() << " contracts in " << elapsed.count() << " seconds.\n";
+    std::cout << "Results written to '" << results_file << "'.\n";
+    return 0;
+}
+
+/**
+ * Reprices a saved scenario set: loads it, asks for the payoffs and runs only the payoff stage
+ *
+ * @param replay_file Replay file written by an interactive run
+ * @return Process exit code
+ */
+int run_replay(const std::string& replay_file) {
+    Simulator sim;
+    try {
+        sim.load_replay(replay_file);
+    } catch (const std::runtime_error& error) {
+        std::cout << "Error: " << error.what() << "\n";
+        return 1;
+    }
+    sim.get_replay_input();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    sim.replay_payoffs(true);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+
+    std::cout << "\n=== REPLAYED RESULTS ===\n";
+    sim.output_results();
+    std::cout << "\nReplay Time: " << elapsed.count() << " seconds.\n";
+
+    sim.price_option_chain();
+    return 0;
+}
+
 /**
  * Main function: gives the user the option to run the simulation with a single thread, multiple threads, or both.
  * It then runs the simulation and outputs the results.
  * It then generates the visualization data and writes it to a CSV file.
  */
-int main() {
+int main(int argc, char* argv[]) {
+    // Non-interactive mode: simulator --batch portfolio.csv [results.csv]
+    if (argc >= 2 && std::string(argv[1]) == "--batch") {
+        if (argc < 3) {
+            std::cout << "Usage: " << argv[0] << " --batch portfolio.csv [results.csv]\n";
+            return 1;
+        }
+        return run_batch(argv[2], argc >= 4 ? argv[3] : "dist/Results.csv");
+    }
+
+    // Replay mode: simulator --replay [replay.bin]
+    if (argc >= 2 && std::string(argv[1]) == "--replay") {
+        return run_replay(argc >= 3 ? argv[2] : "dist/Replay.bin");
+    }
+
+    // Interactive mode: simulator [--csv]; --csv exports text instead of binary columns
+    bool text_output = argc >= 2 && std::string(argv[1]) == "--csv";
+
     Simulator sim;
-    sim.get_user_input();
+    try {
+        sim.get_user_input();
+    } catch (const std::runtime_error& error) {
+        std::cout << "Error: " << error.what() << "\n";
+        return 1;
+    }
+
+    // Visualization data is written in the background while the program moves on
+    AsyncWriter writer;
+    bool exported = false;
+    auto export_paths = [&] {
+        if (!sim.has_paths() || exported) return;
+        std::cout << "Writing visualization data in the background..." << "\n";
+        writer.submit([table = sim.path_averages(), text_output] { write_path_averages(table, text_output); });
+        exported = true;
+    };
 
     std::cout << "Would you like to run the simulation with a single thread or multiple threads? (1 for single, 2 for multiple, 3 for both): ";
     int choice;
@@ -257,6 +1251,10 @@ int main() {
         sim.output_results();
         std::cout << "\nSingle Threaded Time: " << elapsed_single.count() << " seconds.\n";
 
+        // Both runs produce bit-identical paths, so the first run's averages are
+        // written while the second one simulates
+        export_paths();
+
         // Clear data for next run
         sim.clear();
 
@@ -279,10 +1277,40 @@ int main() {
         return 1;
     }
 
-    // Generate visualization data
-    std::cout << "Generating visualization data..." << "\n";
-    sim.write_to_csv();
-    std::cout << "Simulation complete! Check 'dist/Data.csv' for visualization data.\n";
+    // Reuse the simulated paths for additional strikes, while the visualization data is written
+    export_paths();
+    sim.price_option_chain();
+
+    std::cout << "\nSave the scenarios for repricing with --replay? (1 for yes, 0 for no): ";
+    bool save = false;
+    std::cin >> save;
+    if (save) {
+        try {
+            sim.save_replay("dist/Replay.bin", "dist/Paths.bin");
+            std::cout << "Scenarios saved to 'dist/Replay.bin'.\n";
+        } catch (const std::runtime_error& error) {
+            std::cout << "Error: " << error.what() << "\n";
+        }
+    }
+
+    if (sim.has_paths()) {
+        try {
+            writer.flush();
+        } catch (const std::runtime_error& error) {
+            std::cout << "Error: " << error.what() << "\n";
+            return 1;
+        }
+        std::cout << "Simulation complete! Check '" << (text_output ? "dist/Data.csv" : "dist/Data.bin")
+                  << "' for visualization data.\n";
+    } else {
+        // Drop visualization data from earlier runs so the plotter does not present it as this run's
+        std::remove("dist/Data.bin");
+        std::remove("dist/Data.csv");
+        std::cout << "Simulation complete! Averaged paths were not requested, so no visualization data was generated.\n";
+    }
+    if (!sim.full_path_file().empty()) {
+        std::cout << "Every full path was written to '" << sim.full_path_file() << "'.\n";
+    }
     
     return 0;
 }
\ No newline at end of file
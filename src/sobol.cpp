@@ -0,0 +1,273 @@
+#include "sobol.h"
+#include "rng.h"  // for inverse_normal_cdf
+
+#include <cmath>  // for std::sqrt
+
+/**
+ * Implementation of the Sobol sequence, Brownian bridge and quasi-random path tiles
+ */
+
+namespace {
+
+struct InitialNumbers {
+    int degree;
+    std::uint32_t a;  // coefficients of the inner terms of the primitive polynomial
+    std::uint32_t m[7];
+};
+
+// Joe & Kuo, new-joe-kuo-6.21201, dimensions 2-21 (dimension 1 is the van der Corput sequence)
+const InitialNumbers JOE_KUO[] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+    {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}},
+    {6, 25, {1, 1, 5, 5, 19, 61}},
+    {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+    {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+};
+constexpr int JOE_KUO_DIMS = sizeof(JOE_KUO) / sizeof(JOE_KUO[0]);
+
+std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Multiplies two polynomials over GF(2) modulo poly (of the given degree)
+ */
+std::uint64_t mul_mod(std::uint64_t a, std::uint64_t b, std::uint64_t poly, int degree) {
+    std::uint64_t result = 0;
+    while (b) {
+        if (b & 1) result ^= a;
+        b >>= 1;
+        a <<= 1;
+        if ((a >> degree) & 1) a ^= poly;
+    }
+    return result;
+}
+
+std::uint64_t pow_mod(std::uint64_t exponent, std::uint64_t poly, int degree) {
+    std::uint64_t result = 1;
+    std::uint64_t base = 2;  // the polynomial x
+    while (exponent) {
+        if (exponent & 1) result = mul_mod(result, base, poly, degree);
+        base = mul_mod(base, base, poly, degree);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+/**
+ * A degree-s polynomial is primitive iff x has multiplicative order 2^s - 1 modulo it
+ */
+bool is_primitive(std::uint64_t poly, int degree) {
+    std::uint64_t order = (1ULL << degree) - 1;
+    if (degree == 1) return true;
+    if (pow_mod(order, poly, degree) != 1) return false;
+
+    std::uint64_t n = order;
+    for (std::uint64_t q = 2; q * q <= n; q++) {
+        if (n % q != 0) continue;
+        if (pow_mod(order / q, poly, degree) == 1) return false;
+        while (n % q == 0) n /= q;
+    }
+    return n == 1 || pow_mod(order / n, poly, degree) != 1;
+}
+
+/**
+ * Enumerates primitive polynomials in Joe-Kuo order (by degree, then by a)
+ */
+std::vector<InitialNumbers> primitive_polynomials(int count) {
+    std::vector<InitialNumbers> polys;
+    for (int degree = 1; static_cast<int>(polys.size()) < count && degree < SobolSequence::BITS; degree++) {
+        for (std::uint32_t a = 0; a < (1u << (degree - 1)) && static_cast<int>(polys.size()) < count; a++) {
+            std::uint64_t poly = (1ULL << degree) | (static_cast<std::uint64_t>(a) << 1) | 1;
+            if (is_primitive(poly, degree)) {
+                polys.push_back({degree, a, {}});
+            }
+        }
+    }
+    return polys;
+}
+
+std::uint32_t reverse_bits(std::uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+/**
+ * Burley's hash-based nested uniform (Owen) scramble
+ */
+std::uint32_t owen_scramble(std::uint32_t x, std::uint32_t seed) {
+    x = reverse_bits(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reverse_bits(x);
+}
+
+int trailing_zeros(std::uint64_t x) {
+    return __builtin_ctzll(x);
+}
+
+}  // namespace
+
+SobolSequence::SobolSequence(int num_dims, std::uint64_t scramble_seed)
+    : dims(num_dims), directions(static_cast<std::size_t>(num_dims) * BITS) {
+    std::vector<InitialNumbers> polys = primitive_polynomials(dims - 1);
+
+    for (int d = 0; d < dims; d++) {
+        std::uint32_t* v = &directions[static_cast<std::size_t>(d) * BITS];
+        if (d == 0) {
+            for (int k = 0; k < BITS; k++) v[k] = 1u << (BITS - 1 - k);
+            continue;
+        }
+
+        bool tabulated = d - 1 < JOE_KUO_DIMS;
+        InitialNumbers init = tabulated ? JOE_KUO[d - 1] : polys[d - 1];
+        int s = init.degree;
+        for (int k = 0; k < s; k++) {
+            // Generated polynomials can exceed the 7 tabulated initial values, so m is never read for them
+            std::uint32_t m = tabulated
+                ? init.m[k]
+                : static_cast<std::uint32_t>(splitmix64(static_cast<std::uint64_t>(d) * BITS + k) & ((1u << (k + 1)) - 1)) | 1u;
+            v[k] = m << (BITS - 1 - k);
+        }
+        for (int k = s; k < BITS; k++) {
+            v[k] = v[k - s] ^ (v[k - s] >> s);
+            for (int i = 1; i < s; i++) {
+                if ((init.a >> (s - 1 - i)) & 1) v[k] ^= v[k - i];
+            }
+        }
+    }
+
+    if (scramble_seed != 0) {
+        scramble_keys.resize(dims);
+        for (int d = 0; d < dims; d++) {
+            scramble_keys[d] = static_cast<std::uint32_t>(splitmix64(scramble_seed ^ splitmix64(d)));
+        }
+    }
+}
+
+double SobolSequence::to_uniform(std::uint32_t x, int dim) const {
+    if (!scramble_keys.empty()) x = owen_scramble(x, scramble_keys[dim]);
+    return (static_cast<double>(x) + 0.5) * (1.0 / 4294967296.0);  // 2^-32
+}
+
+void SobolSequence::points(std::uint64_t first_index, int count, double* out) const {
+    if (count <= 0) return;
+    std::vector<std::uint32_t> x(dims, 0);
+
+    // Skip-ahead: point i is the XOR of the direction numbers selected by the Gray code of i
+    std::uint64_t gray = first_index ^ (first_index >> 1);
+    for (int bit = 0; bit < BITS; bit++) {
+        if (!((gray >> bit) & 1)) continue;
+        for (int d = 0; d < dims; d++) x[d] ^= directions[static_cast<std::size_t>(d) * BITS + bit];
+    }
+
+    for (int p = 0; p < count; p++) {
+        if (p > 0) {
+            int bit = trailing_zeros(first_index + p);  // Gray codes of i-1 and i differ in this bit
+            for (int d = 0; d < dims; d++) x[d] ^= directions[static_cast<std::size_t>(d) * BITS + bit];
+        }
+        double* point = out + static_cast<std::size_t>(p) * dims;
+        for (int d = 0; d < dims; d++) point[d] = to_uniform(x[d], d);
+    }
+}
+
+/**
+ * Construction order of Jaeckel ("Monte Carlo Methods in Finance"): fill
+ * the terminal point first, then the midpoints of the remaining gaps,
+ * sweeping left to right one level at a time
+ */
+BrownianBridge::BrownianBridge(int num_steps)
+    : steps(num_steps), bridge_index(num_steps), left_index(num_steps), right_index(num_steps),
+      left_weight(num_steps), right_weight(num_steps), stddev(num_steps) {
+    // Unit spacing: t_i = i + 1, t_{-1} = 0
+    auto t = [](int i) { return static_cast<double>(i + 1); };
+    std::vector<int> filled(num_steps, 0);
+
+    filled[num_steps - 1] = 1;
+    bridge_index[0] = num_steps - 1;
+    stddev[0] = std::sqrt(t(num_steps - 1));
+    left_weight[0] = right_weight[0] = 0.0;
+
+    int j = 0;
+    for (int i = 1; i < num_steps; i++) {
+        while (filled[j]) j++;
+        int k = j;
+        while (!filled[k]) k++;
+        int l = j + ((k - 1 - j) >> 1);
+        filled[l] = 1;
+
+        double t_left = j > 0 ? t(j - 1) : 0.0;
+        bridge_index[i] = l;
+        left_index[i] = j;
+        right_index[i] = k;
+        left_weight[i] = (t(k) - t(l)) / (t(k) - t_left);
+        right_weight[i] = (t(l) - t_left) / (t(k) - t_left);
+        stddev[i] = std::sqrt((t(l) - t_left) * (t(k) - t(l)) / (t(k) - t_left));
+
+        j = k + 1;
+        if (j >= num_steps) j = 0;
+    }
+}
+
+void BrownianBridge::build(const double* z, double* increments) const {
+    // Build W(t_i) in place, then difference it
+    double* W = increments;
+    W[steps - 1] = stddev[0] * z[0];
+    for (int i = 1; i < steps; i++) {
+        int j = left_index[i];
+        int k = right_index[i];
+        int l = bridge_index[i];
+        double left = j > 0 ? W[j - 1] : 0.0;
+        W[l] = left_weight[i] * left + right_weight[i] * W[k] + stddev[i] * z[i];
+    }
+    for (int i = steps - 1; i > 0; i--) {
+        W[i] -= W[i - 1];
+    }
+}
+
+SobolPaths::SobolPaths(int num_steps, std::uint64_t scramble_seed)
+    : sequence(num_steps, scramble_seed), bridge(num_steps) { }
+
+void SobolPaths::normals_tile(std::uint64_t first_path, int num_paths, double* out) const {
+    int dims = sequence.dimensions();
+    thread_local std::vector<double> uniforms;
+    thread_local std::vector<double> z;
+    thread_local std::vector<double> increments;
+    uniforms.resize(static_cast<std::size_t>(num_paths) * dims);
+    z.resize(dims);
+    increments.resize(dims);
+
+    // Point 0 is the origin, which maps every coordinate to the far left tail; start at point 1
+    sequence.points(first_path + 1, num_paths, uniforms.data());
+    for (int p = 0; p < num_paths; p++) {
+        inverse_normal_cdf(&uniforms[static_cast<std::size_t>(p) * dims], dims, z.data());
+        bridge.build(z.data(), increments.data());
+        for (int k = 0; k < dims; k++) {
+            out[static_cast<std::size_t>(k) * num_paths + p] = increments[k];
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>  // for std::uint32_t, std::uint64_t
+#include <vector>   // for std::vector
+
+/**
+ * Sobol quasi-Monte Carlo path generation
+ *
+ * Each simulated path is one point of a num_steps-dimensional Sobol
+ * sequence. The point's coordinates are mapped to normals with the inverse
+ * CDF and assigned to time steps through a Brownian bridge: the first
+ * (best distributed) coordinate fixes the terminal value, the next ones
+ * the midpoints, and so on, so the low-discrepancy structure goes to the
+ * coordinates that matter most for the payoff.
+ *
+ * Direction numbers: dimension 1 is the van der Corput sequence and
+ * dimensions 2-21 use Joe and Kuo's new-joe-kuo-6.21201 initial values.
+ * From dimension 22 on (paths of more than 21 steps), the sequence uses
+ * the next primitive polynomials (same enumeration order) with
+ * deterministic pseudo-random odd initial values instead of the Joe-Kuo
+ * table, which is too large to embed. Those dimensions are still valid
+ * Sobol dimensions but lack Joe and Kuo's two-dimensional projection
+ * optimization; with the Brownian bridge they drive the finest path
+ * refinements and carry little of the path's variance.
+ *
+ * Optional Owen scrambling uses the hash-based nested uniform scramble of
+ * Burley (2020), keyed by the seed and the dimension.
+ */
+
+/**
+ * Sobol low-discrepancy sequence with Gray-code skip-ahead
+ */
+class SobolSequence {
+    public:
+        static constexpr int BITS = 32;  // supports up to 2^32 points
+
+        SobolSequence() = default;
+
+        /**
+         * Builds the direction numbers
+         *
+         * @param dims Number of dimensions
+         * @param scramble_seed Owen scrambling seed (0 for the unscrambled sequence)
+         */
+        SobolSequence(int dims, std::uint64_t scramble_seed);
+
+        int dimensions() const { return dims; }
+
+        /**
+         * Writes the uniforms of consecutive points
+         * The first point is computed directly from its index (skip-ahead),
+         * the rest with the Antonov-Saleev Gray-code recursion
+         *
+         * @param first_index Index of the first point
+         * @param count Number of points
+         * @param out Output [point][dimension], values in the open interval (0, 1)
+         */
+        void points(std::uint64_t first_index, int count, double* out) const;
+
+    private:
+        int dims = 0;
+        std::vector<std::uint32_t> directions;  // [dimension][bit]
+        std::vector<std::uint32_t> scramble_keys;  // per dimension, empty if unscrambled
+
+        double to_uniform(std::uint32_t x, int dim) const;
+};
+
+/**
+ * Brownian bridge over equally spaced steps
+ * Maps normals in bridge order to standardized increments in time order
+ */
+class BrownianBridge {
+    public:
+        BrownianBridge() = default;
+        explicit BrownianBridge(int num_steps);
+
+        /**
+         * Builds one path
+         *
+         * @param z Standard normals; z[0] drives the terminal value
+         * @param increments Output: standard normal increments W(t_i) - W(t_{i-1}) with unit spacing
+         */
+        void build(const double* z, double* increments) const;
+
+    private:
+        int steps = 0;
+        std::vector<int> bridge_index;
+        std::vector<int> left_index;
+        std::vector<int> right_index;
+        std::vector<double> left_weight;
+        std::vector<double> right_weight;
+        std::vector<double> stddev;
+};
+
+/**
+ * Quasi-random replacement for PathRng::normals_tile
+ */
+class SobolPaths {
+    public:
+        SobolPaths() = default;
+
+        /**
+         * @param num_steps Time steps per path (= Sobol dimensions)
+         * @param scramble_seed Owen scrambling seed (0 for the unscrambled sequence)
+         */
+        SobolPaths(int num_steps, std::uint64_t scramble_seed);
+
+        /**
+         * Fills a [step][path] tile with the bridged normal increments of
+         * consecutive paths; path i is Sobol point i + 1
+         *
+         * @param first_path Index of the first path
+         * @param num_paths Number of paths
+         * @param out Output buffer of num_steps * num_paths doubles
+         */
+        void normals_tile(std::uint64_t first_path, int num_paths, double* out) const;
+
+        int steps() const { return sequence.dimensions(); }
+
+    private:
+        SobolSequence sequence;
+        BrownianBridge bridge;
+};
@@ -0,0 +1,47 @@
+#include "strike_ladder.h"
+
+#include <algorithm>  // for std::sort, std::upper_bound
+#include <cmath>      // for std::exp
+
+/**
+ * Implementation of the sorted terminal-price strike ladder
+ */
+
+StrikeLadder::StrikeLadder(const std::vector<double>& final_prices, double r, double T)
+    : sorted_prices(final_prices), discount(std::exp(-r * T)) {
+    std::sort(sorted_prices.begin(), sorted_prices.end());
+
+    // Separate prefix and suffix sums: each price enters its strike's formula through a sum over
+    // only the prices on the payoff side of K, never as total minus prefix. Each formula still
+    // subtracts K * count from such a sum, so out-of-the-money strikes (where the tail mean is
+    // close to K) lose about 1e-16 * suffix_sum in absolute terms, far below Monte Carlo error
+    std::size_t N = sorted_prices.size();
+    prefix_sum.assign(N + 1, 0.0);
+    suffix_sum.assign(N + 1, 0.0);
+    for (std::size_t i = 0; i < N; i++) {
+        prefix_sum[i + 1] = prefix_sum[i] + sorted_prices[i];
+    }
+    for (std::size_t i = N; i > 0; i--) {
+        suffix_sum[i - 1] = suffix_sum[i] + sorted_prices[i - 1];
+    }
+}
+
+int StrikeLadder::count_at_or_below(double K) const {
+    return std::upper_bound(sorted_prices.begin(), sorted_prices.end(), K) - sorted_prices.begin();
+}
+
+double StrikeLadder::call_price(double K) const {
+    int N = sorted_prices.size();
+    if (N == 0) return 0.0;
+    int idx = count_at_or_below(K);
+    double payoff_sum = suffix_sum[idx] - K * (N - idx);
+    return discount * (payoff_sum / N);
+}
+
+double StrikeLadder::put_price(double K) const {
+    int N = sorted_prices.size();
+    if (N == 0) return 0.0;
+    int idx = count_at_or_below(K);
+    double payoff_sum = K * idx - prefix_sum[idx];
+    return discount * (payoff_sum / N);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>  // for std::vector
+
+/**
+ * Option-chain pricing from one set of simulated terminal prices
+ *
+ * The terminal prices are sorted once and turned into prefix and suffix
+ * sums. With idx = number of prices <= K:
+ *   Σ max(S_T - K, 0) = suffix_sum[idx] - K * (N - idx)
+ *   Σ max(K - S_T, 0) = K * idx - prefix_sum[idx]
+ * so every additional strike costs one binary search, O(log N), instead of
+ * a full O(N) pass over the prices.
+ */
+class StrikeLadder {
+    public:
+        /**
+         * Sorts the terminal prices and builds the running sums
+         *
+         * @param final_prices Terminal asset prices from a simulation
+         * @param r Risk-free interest rate
+         * @param T Time to expiration
+         */
+        StrikeLadder(const std::vector<double>& final_prices, double r, double T);
+
+        /**
+         * Monte Carlo price of a European call at the given strike
+         * Equivalent to calculate_call_price on the same prices
+         *
+         * @param K Strike price
+         * @return Estimated call option price
+         */
+        double call_price(double K) const;
+
+        /**
+         * Monte Carlo price of a European put at the given strike
+         * Equivalent to calculate_put_price on the same prices
+         *
+         * @param K Strike price
+         * @return Estimated put option price
+         */
+        double put_price(double K) const;
+
+    private:
+        std::vector<double> sorted_prices;
+        std::vector<double> prefix_sum;  // prefix_sum[i] = sum of the i smallest prices
+        std::vector<double> suffix_sum;  // suffix_sum[i] = sum of all but the i smallest prices
+        double discount;
+
+        int count_at_or_below(double K) const;
+};